@@ -143,6 +143,7 @@ blhandler(PG_FUNCTION_ARGS)
 	amroutine->ambeginscan = blbeginscan;
 	amroutine->amrescan = blrescan;
 	amroutine->amgettuple = NULL;
+	amroutine->amgetprefetchtids = NULL;
 	amroutine->amgetbitmap = blgetbitmap;
 	amroutine->amendscan = blendscan;
 	amroutine->ammarkpos = NULL;
@@ -394,7 +394,7 @@ gistScanPage(IndexScanDesc scan, GISTSearchItem *pageItem,
 		return;
 	}
 
-	so->nPageData = so->curPageData = 0;
+	so->nPageData = so->curPageData = so->prefetchPageData = 0;
 	scan->xs_hitup = NULL;		/* might point into pageDataCxt */
 	if (so->pageDataCxt)
 		MemoryContextReset(so->pageDataCxt);
@@ -627,7 +627,7 @@ gistgettuple(IndexScanDesc scan, ScanDirection dir)
 		pgstat_count_index_scan(scan->indexRelation);
 
 		so->firstCall = false;
-		so->curPageData = so->nPageData = 0;
+		so->curPageData = so->nPageData = so->prefetchPageData = 0;
 		scan->xs_hitup = NULL;
 		if (so->pageDataCxt)
 			MemoryContextReset(so->pageDataCxt);
@@ -736,6 +736,33 @@ gistgettuple(IndexScanDesc scan, ScanDirection dir)
 	}
 }
 
+/*
+ * gistgetprefetchtids() -- report heap TIDs of upcoming tuples
+ *
+ * In a non-ordered search, the remaining matches on the current leaf page are
+ * already in so->pageData, so report the heap TIDs of the next ntids of them
+ * that we haven't reported before.  In an ordered search the next tuples
+ * depend on the queue, so we don't try.
+ */
+int
+gistgetprefetchtids(IndexScanDesc scan, ScanDirection dir,
+					ItemPointerData *tids, int ntids)
+{
+	GISTScanOpaque so = (GISTScanOpaque) scan->opaque;
+	int			stop;
+	int			n = 0;
+
+	if (scan->numberOfOrderBys > 0 || so->firstCall)
+		return 0;
+
+	stop = Min(so->curPageData + ntids, so->nPageData);
+	so->prefetchPageData = Max(so->prefetchPageData, so->curPageData);
+	while (so->prefetchPageData < stop)
+		tids[n++] = so->pageData[so->prefetchPageData++].heapPtr;
+
+	return n;
+}
+
 /*
  * gistgetbitmap() -- Get a bitmap of all heap tuple locations
  */
@@ -752,7 +779,7 @@ gistgetbitmap(IndexScanDesc scan, TIDBitmap *tbm)
 	pgstat_count_index_scan(scan->indexRelation);
 
 	/* Begin the scan by processing the root page */
-	so->curPageData = so->nPageData = 0;
+	so->curPageData = so->nPageData = so->prefetchPageData = 0;
 	scan->xs_hitup = NULL;
 	if (so->pageDataCxt)
 		MemoryContextReset(so->pageDataCxt);
@@ -98,6 +98,7 @@ hashhandler(PG_FUNCTION_ARGS)
 	amroutine->ambeginscan = hashbeginscan;
 	amroutine->amrescan = hashrescan;
 	amroutine->amgettuple = hashgettuple;
+	amroutine->amgetprefetchtids = hashgetprefetchtids;
 	amroutine->amgetbitmap = hashgetbitmap;
 	amroutine->amendscan = hashendscan;
 	amroutine->ammarkpos = NULL;
@@ -328,6 +329,52 @@ hashgettuple(IndexScanDesc scan, ScanDirection dir)
 	return res;
 }
 
+/*
+ *	hashgetprefetchtids() -- report heap TIDs of upcoming items
+ *
+ * Report the heap TIDs of the next ntids matching items on the current page
+ * after the one most recently returned, skipping any reported before.
+ */
+int
+hashgetprefetchtids(IndexScanDesc scan, ScanDirection dir,
+					ItemPointerData *tids, int ntids)
+{
+	HashScanOpaque so = (HashScanOpaque) scan->opaque;
+	HashScanPosData *pos = &so->currPos;
+	int			n = 0;
+
+	if (!HashScanPosIsValid(*pos))
+		return 0;
+
+	/* Start over if the direction changed */
+	if (so->prefetchItem >= 0 && so->prefetchDir != dir)
+		so->prefetchItem = -1;
+	so->prefetchDir = dir;
+
+	if (ScanDirectionIsForward(dir))
+	{
+		int			stop = Min(pos->itemIndex + ntids, pos->lastItem);
+		int			item = Max(so->prefetchItem, pos->itemIndex);
+
+		while (item < stop)
+			tids[n++] = pos->items[++item].heapTid;
+		so->prefetchItem = item;
+	}
+	else
+	{
+		int			stop = Max(pos->itemIndex - ntids, pos->firstItem);
+		int			item = pos->itemIndex;
+
+		if (so->prefetchItem >= 0)
+			item = Min(so->prefetchItem, item);
+		while (item > stop)
+			tids[n++] = pos->items[--item].heapTid;
+		so->prefetchItem = item;
+	}
+
+	return n;
+}
+
 
 /*
  *	hashgetbitmap() -- get all tuples at once
@@ -386,6 +433,8 @@ hashbeginscan(Relation rel, int nkeys, int norderbys)
 	so->killedItems = NULL;
 	so->numKilled = 0;
 
+	so->prefetchItem = -1;
+
 	scan->opaque = so;
 
 	return scan;
@@ -412,6 +461,7 @@ hashrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,
 
 	/* set position invalid (this will cause _hash_first call) */
 	HashScanPosInvalidate(so->currPos);
+	so->prefetchItem = -1;
 
 	/* Update scan key, if a new one is given */
 	if (scankey && scan->numberOfKeys > 0)
@@ -461,6 +461,8 @@ _hash_readpage(IndexScanDesc scan, Buffer *bufP, ScanDirection dir)
 
 	so->currPos.buf = buf;
 	so->currPos.currPage = BufferGetBlockNumber(buf);
+	/* items[] is about to be refilled, so nothing on it was prefetched yet */
+	so->prefetchItem = -1;
 
 	if (ScanDirectionIsForward(dir))
 	{
@@ -43,6 +43,7 @@
 #include "catalog/pg_database.h"
 #include "catalog/pg_database_d.h"
 #include "commands/vacuum.h"
+#include "nodes/tidbitmap.h"
 #include "pgstat.h"
 #include "port/pg_bitutils.h"
 #include "storage/lmgr.h"
@@ -277,6 +278,81 @@ heap_scan_stream_read_next_serial(ReadStream *stream,
 	return scan->rs_prefetch_block;
 }
 
+/*
+ * Streaming read API callback for bitmap heap scans.  Returns the next block
+ * named by the bitmap iterator that actually needs to be read, copying its
+ * TBMIterateResult into the per-buffer data so that
+ * heapam_scan_bitmap_next_block() can process it once the buffer is
+ * returned.  Blocks that we can skip fetching are accounted for in
+ * rs_empty_tuples_pending instead.
+ */
+static BlockNumber
+bitmapheap_stream_read_next(ReadStream *stream,
+							void *callback_private_data,
+							void *per_buffer_data)
+{
+	HeapScanDesc scan = (HeapScanDesc) callback_private_data;
+	TableScanDesc sscan = &scan->rs_base;
+	TBMIterateResult *result = per_buffer_data;
+
+	for (;;)
+	{
+		TBMIterateResult *tbmres;
+
+		CHECK_FOR_INTERRUPTS();
+
+		if (sscan->st.bitmap.rs_shared_iterator)
+			tbmres = tbm_shared_iterate(sscan->st.bitmap.rs_shared_iterator);
+		else if (sscan->st.bitmap.rs_iterator)
+			tbmres = tbm_iterate(sscan->st.bitmap.rs_iterator);
+		else
+			tbmres = NULL;
+
+		/* no more entries in the bitmap */
+		if (tbmres == NULL)
+			return InvalidBlockNumber;
+
+		/*
+		 * Ignore any claimed entries past what we think is the end of the
+		 * relation. It may have been extended after the start of our scan (we
+		 * only hold an AccessShareLock, and it could be inserts from this
+		 * backend).  We don't take this optimization in SERIALIZABLE
+		 * isolation though, as we need to examine all invisible tuples
+		 * reachable by the index.
+		 */
+		if (!IsolationIsSerializable() &&
+			tbmres->blockno >= scan->rs_nblocks)
+			continue;
+
+		/*
+		 * We can skip fetching the heap page if we don't need any fields from
+		 * the heap, the bitmap entries don't need rechecking, and all tuples
+		 * on the page are visible to our transaction.
+		 */
+		if (!(sscan->rs_flags & SO_NEED_TUPLES) &&
+			!tbmres->recheck &&
+			VM_ALL_VISIBLE(sscan->rs_rd, tbmres->blockno, &scan->rs_vmbuffer))
+		{
+			/* can't be lossy in the skip_fetch case */
+			Assert(tbmres->ntuples >= 0);
+			Assert(scan->rs_empty_tuples_pending >= 0);
+
+			scan->rs_empty_tuples_pending += tbmres->ntuples;
+			continue;
+		}
+
+		/*
+		 * The iterator's result is overwritten by the next call, so keep a
+		 * copy until the buffer is consumed.
+		 */
+		memcpy(result, tbmres,
+			   offsetof(TBMIterateResult, offsets) +
+			   sizeof(OffsetNumber) * Max(tbmres->ntuples, 0));
+
+		return tbmres->blockno;
+	}
+}
+
 /* ----------------
  *		initscan - scan code common to heap_beginscan and heap_rescan
  * ----------------
@@ -1112,9 +1188,10 @@ heap_beginscan(Relation relation, Snapshot snapshot,
 	scan->rs_read_stream = NULL;
 
 	/*
-	 * Set up a read stream for sequential scans and TID range scans. This
-	 * should be done after initscan() because initscan() allocates the
-	 * BufferAccessStrategy object passed to the read stream API.
+	 * Set up a read stream for sequential scans, TID range scans and bitmap
+	 * scans. This should be done after initscan() because initscan()
+	 * allocates the BufferAccessStrategy object passed to the read stream
+	 * API.
 	 */
 	if (scan->rs_base.rs_flags & SO_TYPE_SEQSCAN ||
 		scan->rs_base.rs_flags & SO_TYPE_TIDRANGESCAN)
@@ -1134,6 +1211,24 @@ heap_beginscan(Relation relation, Snapshot snapshot,
 														  scan,
 														  0);
 	}
+	else if (scan->rs_base.rs_flags & SO_TYPE_BITMAPSCAN)
+	{
+		/*
+		 * The bitmap iterators are installed by the caller after the scan
+		 * has begun, so the callback must not be invoked before the first
+		 * call to heapam_scan_bitmap_next_block().  Each buffer carries a
+		 * copy of its TBMIterateResult, which is only ever as large as the
+		 * maximum number of tuples on a heap page.
+		 */
+		scan->rs_read_stream = read_stream_begin_relation(READ_STREAM_DEFAULT,
+														  scan->rs_strategy,
+														  scan->rs_base.rs_rd,
+														  MAIN_FORKNUM,
+														  bitmapheap_stream_read_next,
+														  scan,
+														  offsetof(TBMIterateResult, offsets) +
+														  sizeof(OffsetNumber) * MaxHeapTuplesPerPage);
+	}
 
 
 	return (TableScanDesc) scan;
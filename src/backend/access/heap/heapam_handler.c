@@ -81,6 +81,7 @@ heapam_index_fetch_begin(Relation rel)
 
 	hscan->xs_base.rel = rel;
 	hscan->xs_cbuf = InvalidBuffer;
+	hscan->xs_prefetch_block = InvalidBlockNumber;
 
 	return &hscan->xs_base;
 }
@@ -107,6 +108,57 @@ heapam_index_fetch_end(IndexFetchTableData *scan)
 	pfree(hscan);
 }
 
+/*
+ * Prefetch the heap blocks of upcoming index scan tuples, so that reading
+ * them overlaps with processing of the current one.
+ *
+ * Neighboring TIDs often point into the same heap block, and when they point
+ * into adjacent blocks the access is sequential and better left to the
+ * kernel's read-ahead, so we skip both.  Once HEAP_INDEX_PREFETCH_MAX_HITS
+ * consecutive blocks turn out to be cached already, we stop issuing requests
+ * for the next HEAP_INDEX_PREFETCH_BACKOFF TIDs, so that scans of cached data
+ * pay for only a few extra buffer lookups.
+ */
+#define HEAP_INDEX_PREFETCH_MAX_HITS	8
+#define HEAP_INDEX_PREFETCH_BACKOFF		256
+
+static void
+heapam_index_fetch_prefetch(struct IndexFetchTableData *scan,
+							ItemPointer tids, int ntids)
+{
+#ifdef USE_PREFETCH
+	IndexFetchHeapData *hscan = (IndexFetchHeapData *) scan;
+
+	for (int i = 0; i < ntids; i++)
+	{
+		BlockNumber blkno = ItemPointerGetBlockNumber(&tids[i]);
+		BlockNumber prevblkno = hscan->xs_prefetch_block;
+		PrefetchBufferResult result;
+
+		if (hscan->xs_prefetch_skip > 0)
+		{
+			hscan->xs_prefetch_skip--;
+			continue;
+		}
+
+		hscan->xs_prefetch_block = blkno;
+		if (BlockNumberIsValid(prevblkno) &&
+			(blkno == prevblkno || blkno == prevblkno + 1 ||
+			 blkno + 1 == prevblkno))
+			continue;
+
+		result = PrefetchBuffer(scan->rel, MAIN_FORKNUM, blkno);
+		if (result.initiated_io)
+			hscan->xs_prefetch_hits = 0;
+		else if (++hscan->xs_prefetch_hits >= HEAP_INDEX_PREFETCH_MAX_HITS)
+		{
+			hscan->xs_prefetch_hits = 0;
+			hscan->xs_prefetch_skip = HEAP_INDEX_PREFETCH_BACKOFF;
+		}
+	}
+#endif
+}
+
 static bool
 heapam_index_fetch_tuple(struct IndexFetchTableData *scan,
 						 ItemPointer tid,
@@ -2115,76 +2167,76 @@ heapam_estimate_rel_size(Relation rel, int32 *attr_widths,
 
 static bool
 heapam_scan_bitmap_next_block(TableScanDesc scan,
-							  BlockNumber *blockno, bool *recheck,
+							  bool *recheck,
 							  uint64 *lossy_pages, uint64 *exact_pages)
 {
 	HeapScanDesc hscan = (HeapScanDesc) scan;
 	BlockNumber block;
+	void	   *per_buffer_data;
 	Buffer		buffer;
 	Snapshot	snapshot;
 	int			ntup;
 	TBMIterateResult *tbmres;
 
+	Assert(hscan->rs_read_stream);
+
 	hscan->rs_cindex = 0;
 	hscan->rs_ntuples = 0;
 
-	*blockno = InvalidBlockNumber;
-	*recheck = true;
+	/* Release buffer containing previous block. */
+	if (BufferIsValid(hscan->rs_cbuf))
+	{
+		ReleaseBuffer(hscan->rs_cbuf);
+		hscan->rs_cbuf = InvalidBuffer;
+	}
 
-	do
+	/*
+	 * Emit any NULL-filled tuples for blocks that the read stream callback
+	 * decided not to fetch, before moving on to the next fetched block.  These
+	 * come from all-visible pages whose bitmap entries are exact, so they
+	 * never need rechecking.
+	 */
+	if (hscan->rs_empty_tuples_pending > 0)
 	{
-		CHECK_FOR_INTERRUPTS();
+		*recheck = false;
+		return true;
+	}
 
-		if (scan->st.bitmap.rs_shared_iterator)
-			tbmres = tbm_shared_iterate(scan->st.bitmap.rs_shared_iterator);
-		else
-			tbmres = tbm_iterate(scan->st.bitmap.rs_iterator);
+	*recheck = true;
 
-		if (tbmres == NULL)
-			return false;
+	hscan->rs_cbuf = read_stream_next_buffer(hscan->rs_read_stream,
+											 &per_buffer_data);
+
+	if (BufferIsInvalid(hscan->rs_cbuf))
+	{
+		if (BufferIsValid(hscan->rs_vmbuffer))
+		{
+			ReleaseBuffer(hscan->rs_vmbuffer);
+			hscan->rs_vmbuffer = InvalidBuffer;
+		}
 
 		/*
-		 * Ignore any claimed entries past what we think is the end of the
-		 * relation. It may have been extended after the start of our scan (we
-		 * only hold an AccessShareLock, and it could be inserts from this
-		 * backend).  We don't take this optimization in SERIALIZABLE
-		 * isolation though, as we need to examine all invisible tuples
-		 * reachable by the index.
+		 * The bitmap is exhausted, but the callback may have skipped more
+		 * blocks while looking ahead for the last one.
 		 */
-	} while (!IsolationIsSerializable() &&
-			 tbmres->blockno >= hscan->rs_nblocks);
-
-	/* Got a valid block */
-	*blockno = tbmres->blockno;
-	*recheck = tbmres->recheck;
+		if (hscan->rs_empty_tuples_pending > 0)
+		{
+			*recheck = false;
+			return true;
+		}
 
-	/*
-	 * We can skip fetching the heap page if we don't need any fields from the
-	 * heap, the bitmap entries don't need rechecking, and all tuples on the
-	 * page are visible to our transaction.
-	 */
-	if (!(scan->rs_flags & SO_NEED_TUPLES) &&
-		!tbmres->recheck &&
-		VM_ALL_VISIBLE(scan->rs_rd, tbmres->blockno, &hscan->rs_vmbuffer))
-	{
-		/* can't be lossy in the skip_fetch case */
-		Assert(tbmres->ntuples >= 0);
-		Assert(hscan->rs_empty_tuples_pending >= 0);
+		return false;
+	}
 
-		hscan->rs_empty_tuples_pending += tbmres->ntuples;
+	tbmres = per_buffer_data;
 
-		return true;
-	}
+	Assert(BlockNumberIsValid(tbmres->blockno));
+	Assert(BufferGetBlockNumber(hscan->rs_cbuf) == tbmres->blockno);
 
-	block = tbmres->blockno;
+	/* Got a valid block */
+	*recheck = tbmres->recheck;
 
-	/*
-	 * Acquire pin on the target heap page, trading in any pin we held before.
-	 */
-	hscan->rs_cbuf = ReleaseAndReadBuffer(hscan->rs_cbuf,
-										  scan->rs_rd,
-										  block);
-	hscan->rs_cblock = block;
+	block = hscan->rs_cblock = tbmres->blockno;
 	buffer = hscan->rs_cbuf;
 	snapshot = scan->rs_snapshot;
 
@@ -2290,11 +2342,13 @@ heapam_scan_bitmap_next_tuple(TableScanDesc scan,
 	Page		page;
 	ItemId		lp;
 
-	if (hscan->rs_empty_tuples_pending > 0)
+	/*
+	 * If we don't have to fetch the tuple, just return nulls.  These are only
+	 * handed out while no block is current, see
+	 * heapam_scan_bitmap_next_block().
+	 */
+	if (hscan->rs_empty_tuples_pending > 0 && BufferIsInvalid(hscan->rs_cbuf))
 	{
-		/*
-		 * If we don't have to fetch the tuple, just return nulls.
-		 */
 		ExecStoreAllNullTuple(slot);
 		hscan->rs_empty_tuples_pending--;
 		return true;
@@ -2639,6 +2693,7 @@ static const TableAmRoutine heapam_methods = {
 	.index_fetch_reset = heapam_index_fetch_reset,
 	.index_fetch_end = heapam_index_fetch_end,
 	.index_fetch_tuple = heapam_index_fetch_tuple,
+	.index_fetch_prefetch = heapam_index_fetch_prefetch,
 
 	.tuple_insert = heapam_tuple_insert,
 	.tuple_insert_speculative = heapam_tuple_insert_speculative,
@@ -685,32 +685,27 @@ heap_page_prune_and_freeze(Relation relation, Buffer buffer,
 		else
 		{
 			/*
-			 * Opportunistically freeze the page if we are generating an FPI
-			 * anyway and if doing so means that we can set the page
-			 * all-frozen afterwards (might not happen until VACUUM's final
-			 * heap pass).
-			 *
-			 * XXX: Previously, we knew if pruning emitted an FPI by checking
-			 * pgWalUsage.wal_fpi before and after pruning.  Once the freeze
-			 * and prune records were combined, this heuristic couldn't be
-			 * used anymore.  The opportunistic freeze heuristic must be
-			 * improved; however, for now, try to approximate the old logic.
+			 * Opportunistically freeze the page if doing so means that we can
+			 * set the page all-frozen afterwards (might not happen until
+			 * VACUUM's final heap pass), and if it adds little WAL volume:
+			 * either we are pruning the page anyway, or it has been or will
+			 * be written out as an FPI for hint bits.  Freezing such pages
+			 * now is much cheaper than having an anti-wraparound VACUUM read,
+			 * dirty and WAL-log them again later.
 			 */
 			if (prstate.all_visible && prstate.all_frozen && prstate.nfrozen > 0)
 			{
 				/*
-				 * Freezing would make the page all-frozen.  Have already
-				 * emitted an FPI or will do so anyway?
+				 * When pruning, the page is dirtied and WAL-logged
+				 * regardless, and the freeze plans ride along in the same
+				 * record.  Otherwise, freeze only if setting hint bits
+				 * already emitted an FPI, or if marking the buffer dirty
+				 * for the hint bits we are about to set will emit one.
 				 */
 				if (RelationNeedsWAL(relation))
 				{
-					if (hint_bit_fpi)
+					if (hint_bit_fpi || do_prune)
 						do_freeze = true;
-					else if (do_prune)
-					{
-						if (XLogCheckBufferNeedsBackup(buffer))
-							do_freeze = true;
-					}
 					else if (do_hint)
 					{
 						if (XLogHintBitIsNeeded() && XLogCheckBufferNeedsBackup(buffer))
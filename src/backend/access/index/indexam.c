@@ -25,6 +25,7 @@
  *		index_parallelrescan  - (re)start a parallel scan of an index
  *		index_beginscan_parallel - join parallel index scan
  *		index_getnext_tid	- get the next TID from a scan
+ *		index_getprefetchtids - get TIDs of upcoming tuples for prefetching
  *		index_fetch_heap		- get the scan's next heap tuple
  *		index_getnext_slot	- get the next tuple from a scan
  *		index_getbitmap - get all tuples from a scan
@@ -612,6 +613,28 @@ index_getnext_tid(IndexScanDesc scan, ScanDirection direction)
 	return &scan->xs_heaptid;
 }
 
+/* ----------------
+ *		index_getprefetchtids - get TIDs of upcoming tuples for prefetching
+ *
+ * Stores into tids[] the heap TIDs of tuples among the next ntids ones that
+ * index_getnext_tid will return in the given direction, as far as the index
+ * AM already knows them, and returns their number.  A TID is only reported
+ * once.  Returns 0 if the index AM doesn't support this.
+ * ----------------
+ */
+int
+index_getprefetchtids(IndexScanDesc scan, ScanDirection direction,
+					  ItemPointerData *tids, int ntids)
+{
+	SCAN_CHECKS;
+
+	if (scan->indexRelation->rd_indam->amgetprefetchtids == NULL)
+		return 0;
+
+	return scan->indexRelation->rd_indam->amgetprefetchtids(scan, direction,
+															tids, ntids);
+}
+
 /* ----------------
  *		index_fetch_heap - get the scan's next heap tuple
  *
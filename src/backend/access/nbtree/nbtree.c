@@ -141,6 +141,7 @@ bthandler(PG_FUNCTION_ARGS)
 	amroutine->ambeginscan = btbeginscan;
 	amroutine->amrescan = btrescan;
 	amroutine->amgettuple = btgettuple;
+	amroutine->amgetprefetchtids = btgetprefetchtids;
 	amroutine->amgetbitmap = btgetbitmap;
 	amroutine->amendscan = btendscan;
 	amroutine->ammarkpos = btmarkpos;
@@ -259,6 +260,55 @@ btgettuple(IndexScanDesc scan, ScanDirection dir)
 	return res;
 }
 
+/*
+ * btgetprefetchtids() -- report heap TIDs of upcoming items
+ *
+ * We already know the TIDs of all the matching items on the current leaf
+ * page, so report those of the next ntids items after the one most recently
+ * returned, skipping any we have reported before.  so->prefetchItem
+ * remembers how far we got; _bt_readpage and btrestrpos forget it whenever
+ * currPos is refilled.
+ */
+int
+btgetprefetchtids(IndexScanDesc scan, ScanDirection dir,
+				  ItemPointerData *tids, int ntids)
+{
+	BTScanOpaque so = (BTScanOpaque) scan->opaque;
+	BTScanPos	pos = &so->currPos;
+	int			n = 0;
+
+	if (!BTScanPosIsValid(*pos))
+		return 0;
+
+	/* Start over if the direction changed */
+	if (so->prefetchItem >= 0 && so->prefetchDir != dir)
+		so->prefetchItem = -1;
+	so->prefetchDir = dir;
+
+	if (ScanDirectionIsForward(dir))
+	{
+		int			stop = Min(pos->itemIndex + ntids, pos->lastItem);
+		int			item = Max(so->prefetchItem, pos->itemIndex);
+
+		while (item < stop)
+			tids[n++] = pos->items[++item].heapTid;
+		so->prefetchItem = item;
+	}
+	else
+	{
+		int			stop = Max(pos->itemIndex - ntids, pos->firstItem);
+		int			item = pos->itemIndex;
+
+		if (so->prefetchItem >= 0)
+			item = Min(so->prefetchItem, item);
+		while (item > stop)
+			tids[n++] = pos->items[--item].heapTid;
+		so->prefetchItem = item;
+	}
+
+	return n;
+}
+
 /*
  * btgetbitmap() -- gets all matching tuples, and adds them to a bitmap
  */
@@ -339,6 +389,8 @@ btbeginscan(Relation rel, int nkeys, int norderbys)
 	so->killedItems = NULL;		/* until needed */
 	so->numKilled = 0;
 
+	so->prefetchItem = -1;
+
 	/*
 	 * We don't know yet whether the scan will be index-only, so we do not
 	 * allocate the tuple workspace arrays until btrescan.  However, we set up
@@ -401,6 +453,8 @@ btrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,
 		so->markTuples = so->currTuples + BLCKSZ;
 	}
 
+	so->prefetchItem = -1;
+
 	/*
 	 * Reset the scan keys
 	 */
@@ -518,6 +572,7 @@ btrestrpos(IndexScanDesc scan)
 			if (so->currTuples)
 				memcpy(so->currTuples, so->markTuples,
 					   so->markPos.nextTupleOffset);
+			so->prefetchItem = -1;
 			/* Reset the scan's array keys (see _bt_steppage for why) */
 			if (so->numArrayKeys)
 			{
@@ -1550,6 +1550,8 @@ _bt_readpage(IndexScanDesc scan, ScanDirection dir, OffsetNumber offnum,
 	so->currPos.lsn = BufferGetLSNAtomic(so->currPos.buf);
 	so->currPos.dir = dir;
 	so->currPos.nextTupleOffset = 0;
+	/* items[] is about to be refilled, so nothing on it was prefetched yet */
+	so->prefetchItem = -1;
 	/* either moreLeft or moreRight should be set now (may be unset later) */
 	Assert(ScanDirectionIsForward(dir) ? so->currPos.moreRight :
 		   so->currPos.moreLeft);
@@ -1938,6 +1938,36 @@ multixact_twophase_postabort(TransactionId xid, uint16 info,
 	multixact_twophase_postcommit(xid, info, recdata, len);
 }
 
+/*
+ * Number of shared buffers for the MultiXact offset and member SLRUs.
+ *
+ * If asked to autotune, use 2MB of offset buffers and 4MB of member buffers
+ * for every 1GB of shared buffers, up to 8MB each.  Members take more room
+ * per MultiXact, and workloads with heavy row locking go through them much
+ * more than through the offsets.  Never use fewer member buffers than the
+ * old fixed default of 32.  Otherwise just cap the configured amount to be
+ * between 16 and the maximum allowed.
+ */
+static int
+MultiXactOffsetShmemBuffers(void)
+{
+	/* auto-tune based on shared buffers */
+	if (multixact_offset_buffers == 0)
+		return SimpleLruAutotuneBuffers(512, 1024);
+
+	return Min(Max(16, multixact_offset_buffers), SLRU_MAX_ALLOWED_BUFFERS);
+}
+
+static int
+MultiXactMemberShmemBuffers(void)
+{
+	/* auto-tune based on shared buffers */
+	if (multixact_member_buffers == 0)
+		return Max(32, SimpleLruAutotuneBuffers(256, 1024));
+
+	return Min(Max(16, multixact_member_buffers), SLRU_MAX_ALLOWED_BUFFERS);
+}
+
 /*
  * Initialization of shared memory for MultiXact.  We use two SLRU areas,
  * thus double memory.  Also, reserve space for the shared MultiXactState
@@ -1954,8 +1984,8 @@ MultiXactShmemSize(void)
 			 mul_size(sizeof(MultiXactId) * 2, MaxOldestSlot))
 
 	size = SHARED_MULTIXACT_STATE_SIZE;
-	size = add_size(size, SimpleLruShmemSize(multixact_offset_buffers, 0));
-	size = add_size(size, SimpleLruShmemSize(multixact_member_buffers, 0));
+	size = add_size(size, SimpleLruShmemSize(MultiXactOffsetShmemBuffers(), 0));
+	size = add_size(size, SimpleLruShmemSize(MultiXactMemberShmemBuffers(), 0));
 
 	return size;
 }
@@ -1967,18 +1997,53 @@ MultiXactShmemInit(void)
 
 	debug_elog2(DEBUG2, "Shared Memory Init for MultiXact");
 
+	/* If auto-tuning is requested, now is the time to do it */
+	if (multixact_offset_buffers == 0)
+	{
+		char		buf[32];
+
+		snprintf(buf, sizeof(buf), "%d", MultiXactOffsetShmemBuffers());
+		SetConfigOption("multixact_offset_buffers", buf, PGC_POSTMASTER,
+						PGC_S_DYNAMIC_DEFAULT);
+
+		/*
+		 * We prefer to report this value's source as PGC_S_DYNAMIC_DEFAULT.
+		 * However, if the DBA explicitly set multixact_offset_buffers = 0 in
+		 * the config file, then PGC_S_DYNAMIC_DEFAULT will fail to override
+		 * that and we must force the matter with PGC_S_OVERRIDE.
+		 */
+		if (multixact_offset_buffers == 0)	/* failed to apply it? */
+			SetConfigOption("multixact_offset_buffers", buf, PGC_POSTMASTER,
+							PGC_S_OVERRIDE);
+	}
+	Assert(multixact_offset_buffers != 0);
+
+	/* Likewise for multixact_member_buffers */
+	if (multixact_member_buffers == 0)
+	{
+		char		buf[32];
+
+		snprintf(buf, sizeof(buf), "%d", MultiXactMemberShmemBuffers());
+		SetConfigOption("multixact_member_buffers", buf, PGC_POSTMASTER,
+						PGC_S_DYNAMIC_DEFAULT);
+		if (multixact_member_buffers == 0)	/* failed to apply it? */
+			SetConfigOption("multixact_member_buffers", buf, PGC_POSTMASTER,
+							PGC_S_OVERRIDE);
+	}
+	Assert(multixact_member_buffers != 0);
+
 	MultiXactOffsetCtl->PagePrecedes = MultiXactOffsetPagePrecedes;
 	MultiXactMemberCtl->PagePrecedes = MultiXactMemberPagePrecedes;
 
 	SimpleLruInit(MultiXactOffsetCtl,
-				  "multixact_offset", multixact_offset_buffers, 0,
+				  "multixact_offset", MultiXactOffsetShmemBuffers(), 0,
 				  "pg_multixact/offsets", LWTRANCHE_MULTIXACTOFFSET_BUFFER,
 				  LWTRANCHE_MULTIXACTOFFSET_SLRU,
 				  SYNC_HANDLER_MULTIXACT_OFFSET,
 				  false);
 	SlruPagePrecedesUnitTests(MultiXactOffsetCtl, MULTIXACT_OFFSETS_PER_PAGE);
 	SimpleLruInit(MultiXactMemberCtl,
-				  "multixact_member", multixact_member_buffers, 0,
+				  "multixact_member", MultiXactMemberShmemBuffers(), 0,
 				  "pg_multixact/members", LWTRANCHE_MULTIXACTMEMBER_BUFFER,
 				  LWTRANCHE_MULTIXACTMEMBER_SLRU,
 				  SYNC_HANDLER_MULTIXACT_MEMBER,
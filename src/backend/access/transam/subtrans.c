@@ -31,6 +31,7 @@
 #include "access/slru.h"
 #include "access/subtrans.h"
 #include "access/transam.h"
+#include "access/xlog.h"
 #include "miscadmin.h"
 #include "pg_trace.h"
 #include "utils/guc_hooks.h"
@@ -73,7 +74,33 @@ static SlruCtlData SubTransCtlData;
 
 #define SubTransCtl  (&SubTransCtlData)
 
+/*
+ * Backend-local cache of SubTransGetTopmostTransaction() results.
+ *
+ * Once a snapshot has overflowed, every visibility check of an XID it
+ * considers running goes to pg_subtrans, and so does every backend that
+ * looks at the same rows.  The chain of parents of an XID never changes, so
+ * we remember resolved chains in a small direct-mapped cache.  Only answers
+ * that reached a true top-level XID are cached, and nothing is cached during
+ * recovery, where subtransaction parents are only learned in batches.
+ *
+ * To be safe against XID wraparound, the cache is emptied whenever
+ * TransactionXmin has moved too far from where it was when the cache was last
+ * reset; see SubTransTopmostCacheCheck().
+ */
+#define SUBTRANS_TOPMOST_CACHE_SIZE 4096
+
+typedef struct SubTransTopmostCacheEntry
+{
+	TransactionId xid;
+	TransactionId topxid;
+} SubTransTopmostCacheEntry;
 
+static SubTransTopmostCacheEntry SubTransTopmostCache[SUBTRANS_TOPMOST_CACHE_SIZE];
+static TransactionId SubTransTopmostCacheXmin = InvalidTransactionId;
+
+
+static void SubTransTopmostCacheCheck(void);
 static int	ZeroSUBTRANSPage(int64 pageno);
 static bool SubTransPagePrecedes(int64 page1, int64 page2);
 
@@ -164,10 +191,21 @@ SubTransGetTopmostTransaction(TransactionId xid)
 {
 	TransactionId parentXid = xid,
 				previousXid = xid;
+	SubTransTopmostCacheEntry *entry;
+	bool		use_cache;
 
 	/* Can't ask about stuff that might not be around anymore */
 	Assert(TransactionIdFollowsOrEquals(xid, TransactionXmin));
 
+	use_cache = !RecoveryInProgress();
+	entry = &SubTransTopmostCache[xid % SUBTRANS_TOPMOST_CACHE_SIZE];
+	if (use_cache)
+	{
+		SubTransTopmostCacheCheck();
+		if (entry->xid == xid)
+			return entry->topxid;
+	}
+
 	while (TransactionIdIsValid(parentXid))
 	{
 		previousXid = parentXid;
@@ -187,9 +225,37 @@ SubTransGetTopmostTransaction(TransactionId xid)
 
 	Assert(TransactionIdIsValid(previousXid));
 
+	/* Remember the answer if we followed the chain all the way to the top */
+	if (use_cache && !TransactionIdIsValid(parentXid))
+	{
+		entry->xid = xid;
+		entry->topxid = previousXid;
+	}
+
 	return previousXid;
 }
 
+/*
+ * Empty the topmost-parent cache if it might contain entries from before an
+ * XID wraparound.
+ *
+ * All cached XIDs follow SubTransTopmostCacheXmin and precede the next XID to
+ * be assigned, which is less than 2^31 XIDs ahead of TransactionXmin.  As long
+ * as TransactionXmin stays within 2^30 XIDs of SubTransTopmostCacheXmin, no
+ * cached XID can have been reused.  If TransactionXmin moved backwards, as it
+ * can when a snapshot is imported, we just start over as well.
+ */
+static void
+SubTransTopmostCacheCheck(void)
+{
+	if (TransactionIdIsValid(SubTransTopmostCacheXmin) &&
+		TransactionXmin - SubTransTopmostCacheXmin < ((TransactionId) 1 << 30))
+		return;
+
+	memset(SubTransTopmostCache, 0, sizeof(SubTransTopmostCache));
+	SubTransTopmostCacheXmin = TransactionXmin;
+}
+
 /*
  * Number of shared SUBTRANS buffers.
  *
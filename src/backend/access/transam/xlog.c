@@ -115,6 +115,7 @@ int			max_wal_size_mb = 1024; /* 1 GB */
 int			min_wal_size_mb = 80;	/* 80 MB */
 int			wal_keep_size_mb = 0;
 int			XLOGbuffers = -1;
+int			XLogInsertLocks = -1;
 int			XLogArchiveTimeout = 0;
 int			XLogArchiveMode = ARCHIVE_MODE_OFF;
 char	   *XLogArchiveCommand = NULL;
@@ -122,6 +123,7 @@ bool		EnableHotStandby = false;
 bool		fullPageWrites = true;
 bool		wal_log_hints = false;
 int			wal_compression = WAL_COMPRESSION_NONE;
+int			wal_compression_threshold = -1;
 char	   *wal_consistency_checking_string = NULL;
 bool	   *wal_consistency_checking = NULL;
 bool		wal_init_zero = true;
@@ -143,11 +145,15 @@ bool		XLOG_DEBUG = false;
 int			wal_segment_size = DEFAULT_XLOG_SEG_SIZE;
 
 /*
- * Number of WAL insertion locks to use. A higher value allows more insertions
- * to happen concurrently, but adds some CPU overhead to flushing the WAL,
- * which needs to iterate all the locks.
+ * Number of WAL insertion locks to use, set by the wal_insert_locks GUC. A
+ * higher value allows more insertions to happen concurrently, but adds some
+ * CPU overhead to flushing the WAL, which needs to iterate all the locks.
+ *
+ * WALInsertLockAcquireExclusive() holds all of the locks at once, which is
+ * why MAX_XLOGINSERT_LOCKS must stay well below MAX_SIMUL_LWLOCKS.
  */
-#define NUM_XLOGINSERT_LOCKS  8
+#define NUM_XLOGINSERT_LOCKS  XLogInsertLocks
+#define MIN_XLOGINSERT_LOCKS  8
 
 /*
  * Max distance from last checkpoint, before triggering a new xlog-based
@@ -801,8 +807,8 @@ XLogInsertRecord(XLogRecData *rdata,
 	 * To keep track of which insertions are still in-progress, each concurrent
 	 * inserter acquires an insertion lock. In addition to just indicating that
 	 * an insertion is in progress, the lock tells others how far the inserter
-	 * has progressed. There is a small fixed number of insertion locks,
-	 * determined by NUM_XLOGINSERT_LOCKS. When an inserter crosses a page
+	 * has progressed. There is a small number of insertion locks, set at
+	 * server start by wal_insert_locks. When an inserter crosses a page
 	 * boundary, it updates the value stored in the lock to the how far it has
 	 * inserted, to allow the previous buffer to be flushed.
 	 *
@@ -1031,7 +1037,7 @@ XLogInsertRecord(XLogRecData *rdata,
 		/* We also need temporary space to decode the record. */
 		record = (XLogRecord *) recordBuf.data;
 		decoded = (DecodedXLogRecord *)
-			palloc(DecodeXLogRecordRequiredSpace(record->xl_tot_len));
+			palloc(DecodeXLogRecordRequiredSpace(XLogRecordUncompressedLen(record)));
 
 		if (!debug_reader)
 			debug_reader = XLogReaderAllocate(wal_segment_size, NULL,
@@ -4630,6 +4636,52 @@ XLOGChooseNumBuffers(void)
 	return xbuffers;
 }
 
+/*
+ * Auto-tune the number of WAL insertion locks.
+ *
+ * Eight locks used to be a hard-wired value, and are plenty for small
+ * systems.  With many connections, more of them may be inserting WAL
+ * concurrently, so allow one lock per 16 connections, up to the maximum.
+ *
+ * This should not be called until MaxConnections has received its final
+ * value.
+ */
+static int
+XLOGChooseNumInsertLocks(void)
+{
+	int			nlocks;
+
+	nlocks = MaxConnections / 16;
+	if (nlocks > MAX_XLOGINSERT_LOCKS)
+		nlocks = MAX_XLOGINSERT_LOCKS;
+	if (nlocks < MIN_XLOGINSERT_LOCKS)
+		nlocks = MIN_XLOGINSERT_LOCKS;
+	return nlocks;
+}
+
+/*
+ * GUC check_hook for wal_insert_locks
+ */
+bool
+check_wal_insert_locks(int *newval, void **extra, GucSource source)
+{
+	/*
+	 * -1 indicates a request for auto-tune.  If we haven't yet changed the
+	 * boot_val default of -1, just let it be; we'll fix it when
+	 * XLOGShmemSize is called.  Otherwise, substitute the auto-tune value.
+	 */
+	if (*newval == -1 && XLogInsertLocks != -1)
+		*newval = XLOGChooseNumInsertLocks();
+
+	if (*newval == 0)
+	{
+		GUC_check_errdetail("At least one WAL insertion lock is required.");
+		return false;
+	}
+
+	return true;
+}
+
 /*
  * GUC check_hook for wal_buffers
  */
@@ -4893,6 +4945,20 @@ XLOGShmemSize(void)
 	}
 	Assert(XLOGbuffers > 0);
 
+	/* Likewise for wal_insert_locks, which depends on max_connections */
+	if (XLogInsertLocks == -1)
+	{
+		char		buf[32];
+
+		snprintf(buf, sizeof(buf), "%d", XLOGChooseNumInsertLocks());
+		SetConfigOption("wal_insert_locks", buf, PGC_POSTMASTER,
+						PGC_S_DYNAMIC_DEFAULT);
+		if (XLogInsertLocks == -1)	/* failed to apply it? */
+			SetConfigOption("wal_insert_locks", buf, PGC_POSTMASTER,
+							PGC_S_OVERRIDE);
+	}
+	Assert(XLogInsertLocks > 0);
+
 	/* XLogCtl */
 	size = sizeof(XLogCtlData);
 
@@ -61,6 +61,31 @@
 /* Buffer size required to store a compressed version of backup block image */
 #define COMPRESS_BUFSIZE	Max(Max(PGLZ_MAX_BLCKSZ, LZ4_MAX_BLCKSZ), ZSTD_MAX_BLCKSZ)
 
+/*
+ * Records without full-page images are compressed as a whole only if their
+ * contents following the XLogRecord header fit in COMPRESS_RECORD_MAXLEN
+ * bytes, so that the working buffers can be allocated up front.
+ */
+#define COMPRESS_RECORD_MAXLEN	(2 * BLCKSZ)
+
+#ifdef USE_LZ4
+#define	LZ4_MAX_RECORD_LEN		LZ4_COMPRESSBOUND(COMPRESS_RECORD_MAXLEN)
+#else
+#define LZ4_MAX_RECORD_LEN		0
+#endif
+
+#ifdef USE_ZSTD
+#define ZSTD_MAX_RECORD_LEN		ZSTD_COMPRESSBOUND(COMPRESS_RECORD_MAXLEN)
+#else
+#define ZSTD_MAX_RECORD_LEN		0
+#endif
+
+#define PGLZ_MAX_RECORD_LEN		PGLZ_MAX_OUTPUT(COMPRESS_RECORD_MAXLEN)
+
+/* Buffer size required to store a compressed version of a whole record */
+#define COMPRESS_RECORD_BUFSIZE \
+	Max(Max(PGLZ_MAX_RECORD_LEN, LZ4_MAX_RECORD_LEN), ZSTD_MAX_RECORD_LEN)
+
 /*
  * For each block reference registered with XLogRegisterBuffer, we fill in
  * a registered_buffer struct.
@@ -113,6 +138,16 @@ static uint8 curinsert_flags = 0;
 static XLogRecData hdr_rdt;
 static char *hdr_scratch = NULL;
 
+/*
+ * Working areas for compressing a whole record: 'record_scratch' holds the
+ * uncompressed record contents following the XLogRecord header, and
+ * 'compressed_record' the compressed version of that, which is referenced
+ * by 'compressed_rdt'.
+ */
+static XLogRecData compressed_rdt;
+static char *record_scratch = NULL;
+static char *compressed_record = NULL;
+
 #define SizeOfXlogOrigin	(sizeof(RepOriginId) + sizeof(char))
 #define SizeOfXLogTransactionId	(sizeof(TransactionId) + sizeof(char))
 
@@ -138,6 +173,10 @@ static XLogRecData *XLogRecordAssemble(RmgrId rmid, uint8 info,
 									   XLogRecPtr RedoRecPtr, bool doPageWrites,
 									   XLogRecPtr *fpw_lsn, int *num_fpi,
 									   bool *topxid_included);
+static uint64 XLogCompressRecord(uint64 total_len);
+static uint8 XLogCompressionMethod(void);
+static int32 XLogCompressData(const char *source, int32 slen, char *dest,
+							  int32 dest_size);
 static bool XLogCompressBackupBlock(const char *page, uint16 hole_offset,
 									uint16 hole_length, char *dest, uint16 *dlen);
 
@@ -726,33 +765,7 @@ XLogRecordAssemble(RmgrId rmid, uint8 info,
 				bimg.length = compressed_len;
 
 				/* Set the compression method used for this block */
-				switch ((WalCompression) wal_compression)
-				{
-					case WAL_COMPRESSION_PGLZ:
-						bimg.bimg_info |= BKPIMAGE_COMPRESS_PGLZ;
-						break;
-
-					case WAL_COMPRESSION_LZ4:
-#ifdef USE_LZ4
-						bimg.bimg_info |= BKPIMAGE_COMPRESS_LZ4;
-#else
-						elog(ERROR, "LZ4 is not supported by this build");
-#endif
-						break;
-
-					case WAL_COMPRESSION_ZSTD:
-#ifdef USE_ZSTD
-						bimg.bimg_info |= BKPIMAGE_COMPRESS_ZSTD;
-#else
-						elog(ERROR, "zstd is not supported by this build");
-#endif
-						break;
-
-					case WAL_COMPRESSION_NONE:
-						Assert(false);	/* cannot happen */
-						break;
-						/* no default case, so that compiler will warn */
-				}
+				bimg.bimg_info |= XLogCompressionMethod();
 
 				rdt_datas_last->data = regbuf->compressed_page;
 				rdt_datas_last->len = compressed_len;
@@ -892,6 +905,20 @@ XLogRecordAssemble(RmgrId rmid, uint8 info,
 	hdr_rdt.len = (scratch - hdr_scratch);
 	total_len += hdr_rdt.len;
 
+	/*
+	 * If the record is large enough, try to compress it as a whole.  Records
+	 * carrying full-page images are left alone, as the images are compressed
+	 * on their own, and so are XLOG records, which are sometimes read before
+	 * the usual decoding machinery is ready.
+	 */
+	if (wal_compression != WAL_COMPRESSION_NONE &&
+		wal_compression_threshold >= 0 &&
+		*num_fpi == 0 &&
+		rmid != RM_XLOG_ID &&
+		total_len - SizeOfXLogRecord >= wal_compression_threshold &&
+		total_len - SizeOfXLogRecord <= COMPRESS_RECORD_MAXLEN)
+		total_len = XLogCompressRecord(total_len);
+
 	/*
 	 * Calculate CRC of the data
 	 *
@@ -934,50 +961,75 @@ XLogRecordAssemble(RmgrId rmid, uint8 info,
 }
 
 /*
- * Create a compressed version of a backup block image.
+ * Replace the contents of an assembled record following the XLogRecord header
+ * with a compressed version of them, if that makes the record shorter.
  *
- * Returns false if compression fails (i.e., compressed result is actually
- * bigger than original). Otherwise, returns true and sets 'dlen' to
- * the length of compressed block image.
+ * 'total_len' is the current length of the record.  Returns the new length,
+ * which is the same if the record was not compressed.
  */
-static bool
-XLogCompressBackupBlock(const char *page, uint16 hole_offset, uint16 hole_length,
-						char *dest, uint16 *dlen)
+static uint64
+XLogCompressRecord(uint64 total_len)
 {
-	int32		orig_len = BLCKSZ - hole_length;
-	int32		len = -1;
-	int32		extra_bytes = 0;
-	const char *source;
-	PGAlignedBlock tmp;
+	int32		orig_len = (int32) (total_len - SizeOfXLogRecord);
+	int32		len;
+	char	   *ptr = record_scratch;
+	XLogRecData *rdt;
+	char	   *scratch;
 
-	if (hole_length != 0)
-	{
-		/* must skip the hole */
-		memcpy(tmp.data, page, hole_offset);
-		memcpy(tmp.data + hole_offset,
-			   page + (hole_offset + hole_length),
-			   BLCKSZ - (hole_length + hole_offset));
-		source = tmp.data;
+	Assert(orig_len <= COMPRESS_RECORD_MAXLEN);
 
-		/*
-		 * Extra data needs to be stored in WAL record for the compressed
-		 * version of block image if the hole exists.
-		 */
-		extra_bytes = SizeOfXLogRecordBlockCompressHeader;
+	/* Gather the headers and the data into contiguous space */
+	memcpy(ptr, hdr_scratch + SizeOfXLogRecord, hdr_rdt.len - SizeOfXLogRecord);
+	ptr += hdr_rdt.len - SizeOfXLogRecord;
+	for (rdt = hdr_rdt.next; rdt != NULL; rdt = rdt->next)
+	{
+		memcpy(ptr, rdt->data, rdt->len);
+		ptr += rdt->len;
 	}
-	else
-		source = page;
+	Assert(ptr - record_scratch == orig_len);
+
+	len = XLogCompressData(record_scratch, orig_len, compressed_record,
+						   COMPRESS_RECORD_BUFSIZE);
+
+	/* Not worth it unless we save more than the extra header costs */
+	if (len < 0 || len + SizeOfXLogRecordCompressedHeader >= orig_len)
+		return total_len;
+
+	scratch = hdr_scratch + SizeOfXLogRecord;
+	*(scratch++) = (char) XLR_BLOCK_ID_COMPRESSED;
+	*(scratch++) = (char) XLogCompressionMethod();
+	memcpy(scratch, &orig_len, sizeof(uint32));
+	scratch += sizeof(uint32);
+	hdr_rdt.len = scratch - hdr_scratch;
+
+	compressed_rdt.data = compressed_record;
+	compressed_rdt.len = len;
+	compressed_rdt.next = NULL;
+	hdr_rdt.next = &compressed_rdt;
+
+	return hdr_rdt.len + len;
+}
+
+/*
+ * Compress 'slen' bytes at 'source' into 'dest', which has room for
+ * 'dest_size' bytes, using the method selected by wal_compression.
+ *
+ * Returns the compressed length, or -1 if compression failed.
+ */
+static int32
+XLogCompressData(const char *source, int32 slen, char *dest, int32 dest_size)
+{
+	int32		len = -1;
 
 	switch ((WalCompression) wal_compression)
 	{
 		case WAL_COMPRESSION_PGLZ:
-			len = pglz_compress(source, orig_len, dest, PGLZ_strategy_default);
+			len = pglz_compress(source, slen, dest, PGLZ_strategy_default);
 			break;
 
 		case WAL_COMPRESSION_LZ4:
 #ifdef USE_LZ4
-			len = LZ4_compress_default(source, dest, orig_len,
-									   COMPRESS_BUFSIZE);
+			len = LZ4_compress_default(source, dest, slen, dest_size);
 			if (len <= 0)
 				len = -1;		/* failure */
 #else
@@ -987,7 +1039,7 @@ XLogCompressBackupBlock(const char *page, uint16 hole_offset, uint16 hole_length
 
 		case WAL_COMPRESSION_ZSTD:
 #ifdef USE_ZSTD
-			len = ZSTD_compress(dest, COMPRESS_BUFSIZE, source, orig_len,
+			len = ZSTD_compress(dest, dest_size, source, slen,
 								ZSTD_CLEVEL_DEFAULT);
 			if (ZSTD_isError(len))
 				len = -1;		/* failure */
@@ -1002,6 +1054,83 @@ XLogCompressBackupBlock(const char *page, uint16 hole_offset, uint16 hole_length
 			/* no default case, so that compiler will warn */
 	}
 
+	return len;
+}
+
+/*
+ * Return the BKPIMAGE_COMPRESS_* flag for the method selected by
+ * wal_compression.
+ */
+static uint8
+XLogCompressionMethod(void)
+{
+	switch ((WalCompression) wal_compression)
+	{
+		case WAL_COMPRESSION_PGLZ:
+			return BKPIMAGE_COMPRESS_PGLZ;
+
+		case WAL_COMPRESSION_LZ4:
+#ifdef USE_LZ4
+			return BKPIMAGE_COMPRESS_LZ4;
+#else
+			elog(ERROR, "LZ4 is not supported by this build");
+#endif
+			break;
+
+		case WAL_COMPRESSION_ZSTD:
+#ifdef USE_ZSTD
+			return BKPIMAGE_COMPRESS_ZSTD;
+#else
+			elog(ERROR, "zstd is not supported by this build");
+#endif
+			break;
+
+		case WAL_COMPRESSION_NONE:
+			Assert(false);		/* cannot happen */
+			break;
+			/* no default case, so that compiler will warn */
+	}
+
+	return 0;
+}
+
+/*
+ * Create a compressed version of a backup block image.
+ *
+ * Returns false if compression fails (i.e., compressed result is actually
+ * bigger than original). Otherwise, returns true and sets 'dlen' to
+ * the length of compressed block image.
+ */
+static bool
+XLogCompressBackupBlock(const char *page, uint16 hole_offset, uint16 hole_length,
+						char *dest, uint16 *dlen)
+{
+	int32		orig_len = BLCKSZ - hole_length;
+	int32		len;
+	int32		extra_bytes = 0;
+	const char *source;
+	PGAlignedBlock tmp;
+
+	if (hole_length != 0)
+	{
+		/* must skip the hole */
+		memcpy(tmp.data, page, hole_offset);
+		memcpy(tmp.data + hole_offset,
+			   page + (hole_offset + hole_length),
+			   BLCKSZ - (hole_length + hole_offset));
+		source = tmp.data;
+
+		/*
+		 * Extra data needs to be stored in WAL record for the compressed
+		 * version of block image if the hole exists.
+		 */
+		extra_bytes = SizeOfXLogRecordBlockCompressHeader;
+	}
+	else
+		source = page;
+
+	len = XLogCompressData(source, orig_len, dest, COMPRESS_BUFSIZE);
+
 	/*
 	 * We recheck the actual size even if compression reports success and see
 	 * if the number of bytes saved by compression is larger than the length
@@ -1389,4 +1518,15 @@ InitXLogInsert(void)
 	if (hdr_scratch == NULL)
 		hdr_scratch = MemoryContextAllocZero(xloginsert_cxt,
 											 HEADER_SCRATCH_SIZE);
+
+	/*
+	 * And buffers for compressing whole records.
+	 */
+	if (record_scratch == NULL)
+	{
+		record_scratch = MemoryContextAlloc(xloginsert_cxt,
+											COMPRESS_RECORD_MAXLEN);
+		compressed_record = MemoryContextAlloc(xloginsert_cxt,
+											   COMPRESS_RECORD_BUFSIZE);
+	}
 }
@@ -51,6 +51,8 @@ static bool ValidXLogRecordHeader(XLogReaderState *state, XLogRecPtr RecPtr,
 static bool ValidXLogRecord(XLogReaderState *state, XLogRecord *record,
 							XLogRecPtr recptr);
 static void ResetDecoder(XLogReaderState *state);
+static bool XLogDecompressRecord(XLogReaderState *state, char **ptr,
+								 uint32 *remaining);
 static void WALOpenSegmentInit(WALOpenSegment *seg, WALSegmentContext *segcxt,
 							   int segsize, const char *waldir);
 
@@ -169,6 +171,8 @@ XLogReaderFree(XLogReaderState *state)
 	pfree(state->errormsg_buf);
 	if (state->readRecordBuf)
 		pfree(state->readRecordBuf);
+	if (state->decompressBuf)
+		pfree(state->decompressBuf);
 	pfree(state->readBuf);
 	pfree(state);
 }
@@ -532,7 +536,8 @@ XLogDecodeNextRecord(XLogReaderState *state, bool nonblocking)
 	XLogRecPtr	targetPagePtr;
 	bool		randAccess;
 	uint32		len,
-				total_len;
+				total_len,
+				decoded_len;
 	uint32		targetRecOff;
 	uint32		pageHeaderSize;
 	bool		assembled;
@@ -870,15 +875,32 @@ restart:
 		state->NextRecPtr -= XLogSegmentOffset(state->NextRecPtr, state->segcxt.ws_segsize);
 	}
 
+	/*
+	 * A record that was compressed as a whole needs room for its
+	 * decompressed contents, which we could only find out now that we have
+	 * read all of it.  Forget about the space we found above, if any, and
+	 * look again.  Nothing was consumed, so there is nothing to undo unless
+	 * it was an oversized allocation.
+	 */
+	decoded_len = XLogRecordUncompressedLen(record);
+	if (decoded_len != total_len && decoded != NULL)
+	{
+		if (decoded->oversized)
+			pfree(decoded);
+		decoded = NULL;
+	}
+
 	/*
 	 * If we got here without a DecodedXLogRecord, it means we needed to
 	 * validate total_len before trusting it, but by now we've done that.
+	 * Compressed records are decoded even when we're only reading ahead, as
+	 * we have already consumed them from the WAL.
 	 */
 	if (decoded == NULL)
 	{
-		Assert(!nonblocking);
+		Assert(!nonblocking || decoded_len != total_len);
 		decoded = XLogReadRecordAlloc(state,
-									  total_len,
+									  decoded_len,
 									  true /* allow_oversized */ );
 		/* allocation should always happen under allow_oversized */
 		Assert(decoded != NULL);
@@ -1616,6 +1638,153 @@ ResetDecoder(XLogReaderState *state)
 	state->errormsg_deferred = false;
 }
 
+/*
+ * Return the length a record would have if it had not been compressed as a
+ * whole.  For most records, that is just xl_tot_len.  This is the length to
+ * pass to DecodeXLogRecordRequiredSpace().
+ *
+ * The record must have been read in full.  If its compressed header is
+ * damaged, DecodeXLogRecord() will notice, so we just return something that
+ * keeps the decoding within bounds in that case.
+ */
+uint32
+XLogRecordUncompressedLen(XLogRecord *record)
+{
+	char	   *ptr = (char *) record + SizeOfXLogRecord;
+	uint32		raw_len;
+
+	if (record->xl_tot_len < SizeOfXLogRecord + SizeOfXLogRecordCompressedHeader ||
+		(uint8) *ptr != XLR_BLOCK_ID_COMPRESSED)
+		return record->xl_tot_len;
+
+	memcpy(&raw_len, ptr + sizeof(uint8) * 2, sizeof(uint32));
+	if (raw_len > XLogRecordMaxSize - SizeOfXLogRecord)
+		return record->xl_tot_len;
+
+	return SizeOfXLogRecord + raw_len;
+}
+
+/*
+ * Decompress the contents of a record that was compressed as a whole.
+ *
+ * On entry, *ptr points to the XLogRecordCompressedHeader following the
+ * record header, and *remaining is the number of bytes from there to the end
+ * of the record.  On success, they are updated to describe the decompressed
+ * contents, which are stored in state->decompressBuf.
+ */
+static bool
+XLogDecompressRecord(XLogReaderState *state, char **ptr, uint32 *remaining)
+{
+	char	   *src = *ptr;
+	uint32		slen = *remaining;
+	uint8		method;
+	uint32		raw_len;
+	bool		decomp_success = true;
+
+	if (slen < SizeOfXLogRecordCompressedHeader)
+	{
+		report_invalid_record(state,
+							  "record with invalid length at %X/%X",
+							  LSN_FORMAT_ARGS(state->ReadRecPtr));
+		return false;
+	}
+	src += sizeof(uint8);
+	method = (uint8) *src;
+	src += sizeof(uint8);
+	memcpy(&raw_len, src, sizeof(uint32));
+	src += sizeof(uint32);
+	slen -= SizeOfXLogRecordCompressedHeader;
+
+	if (raw_len > XLogRecordMaxSize - SizeOfXLogRecord)
+	{
+		report_invalid_record(state,
+							  "invalid uncompressed length %u in record at %X/%X",
+							  raw_len,
+							  LSN_FORMAT_ARGS(state->ReadRecPtr));
+		return false;
+	}
+
+	/* Enlarge the decompression buffer if needed */
+	if (raw_len > state->decompressBufSize)
+	{
+		uint32		newSize = raw_len;
+
+		newSize += XLOG_BLCKSZ - (newSize % XLOG_BLCKSZ);
+		if (state->decompressBuf)
+			pfree(state->decompressBuf);
+		state->decompressBufSize = 0;
+
+		/*
+		 * Don't let a failed allocation escalate to an ERROR; in the startup
+		 * process that would take down the server.  Report it as an invalid
+		 * record instead, as for other problems with the record.
+		 */
+		state->decompressBuf = (char *) palloc_extended(newSize,
+														MCXT_ALLOC_NO_OOM);
+		if (!state->decompressBuf)
+		{
+			report_invalid_record(state,
+								  "out of memory while trying to decode a record of length %u",
+								  raw_len);
+			return false;
+		}
+		state->decompressBufSize = newSize;
+	}
+
+	if (method == BKPIMAGE_COMPRESS_PGLZ)
+	{
+		if (pglz_decompress(src, slen, state->decompressBuf,
+							raw_len, true) != (int32) raw_len)
+			decomp_success = false;
+	}
+	else if (method == BKPIMAGE_COMPRESS_LZ4)
+	{
+#ifdef USE_LZ4
+		if (LZ4_decompress_safe(src, state->decompressBuf,
+								slen, raw_len) != (int) raw_len)
+			decomp_success = false;
+#else
+		report_invalid_record(state, "could not decompress record at %X/%X compressed with %s not supported by build",
+							  LSN_FORMAT_ARGS(state->ReadRecPtr),
+							  "LZ4");
+		return false;
+#endif
+	}
+	else if (method == BKPIMAGE_COMPRESS_ZSTD)
+	{
+#ifdef USE_ZSTD
+		size_t		decomp_result = ZSTD_decompress(state->decompressBuf,
+													raw_len,
+													src, slen);
+
+		if (ZSTD_isError(decomp_result) || decomp_result != raw_len)
+			decomp_success = false;
+#else
+		report_invalid_record(state, "could not decompress record at %X/%X compressed with %s not supported by build",
+							  LSN_FORMAT_ARGS(state->ReadRecPtr),
+							  "zstd");
+		return false;
+#endif
+	}
+	else
+	{
+		report_invalid_record(state, "could not decompress record at %X/%X compressed with unknown method",
+							  LSN_FORMAT_ARGS(state->ReadRecPtr));
+		return false;
+	}
+
+	if (!decomp_success)
+	{
+		report_invalid_record(state, "could not decompress record at %X/%X",
+							  LSN_FORMAT_ARGS(state->ReadRecPtr));
+		return false;
+	}
+
+	*ptr = state->decompressBuf;
+	*remaining = raw_len;
+	return true;
+}
+
 /*
  * Compute the maximum possible amount of padding that could be required to
  * decode a record, given xl_tot_len from the record's header.  This is the
@@ -1696,6 +1865,13 @@ DecodeXLogRecord(XLogReaderState *state,
 	ptr += SizeOfXLogRecord;
 	remaining = record->xl_tot_len - SizeOfXLogRecord;
 
+	/* If the record was compressed as a whole, decode its expanded form */
+	if (remaining > 0 && (uint8) *ptr == XLR_BLOCK_ID_COMPRESSED)
+	{
+		if (!XLogDecompressRecord(state, &ptr, &remaining))
+			goto err;
+	}
+
 	/* Decode the headers */
 	datatotal = 0;
 	while (remaining > datatotal)
@@ -1946,7 +2122,7 @@ DecodeXLogRecord(XLogReaderState *state,
 
 	/* Report the actual size we used. */
 	decoded->size = MAXALIGN(out - (char *) decoded);
-	Assert(DecodeXLogRecordRequiredSpace(record->xl_tot_len) >=
+	Assert(DecodeXLogRecordRequiredSpace(XLogRecordUncompressedLen(record)) >=
 		   decoded->size);
 
 	return true;
@@ -497,10 +497,19 @@ XLogReadBufferExtended(RelFileLocator rlocator, ForkNumber forknum,
 	 * the writes, but that seems like it risks losing valuable data if the
 	 * filesystem loses an inode during a crash.  Better to write the data
 	 * until we are actually told to delete the file.)
+	 *
+	 * Replay touches the same forks over and over, so skip that when we
+	 * already know the fork's size and the block lies within it: the fork
+	 * must exist, and going through smgrcreate() for every block referenced
+	 * by every record is measurable overhead in the single-threaded startup
+	 * process.
 	 */
-	smgrcreate(smgr, forknum, true);
-
-	lastblock = smgrnblocks(smgr, forknum);
+	lastblock = smgrnblocks_cached(smgr, forknum);
+	if (lastblock == InvalidBlockNumber || blkno >= lastblock)
+	{
+		smgrcreate(smgr, forknum, true);
+		lastblock = smgrnblocks(smgr, forknum);
+	}
 
 	if (blkno < lastblock)
 	{
@@ -1621,6 +1621,7 @@ createdb_failure_callback(int code, Datum arg)
 	if (fparms->strategy == CREATEDB_WAL_LOG)
 	{
 		DropDatabaseBuffers(fparms->dest_dboid);
+		smgrforgetdatabasesizes(fparms->dest_dboid);
 		ForgetDatabaseSyncRequests(fparms->dest_dboid);
 
 		/* Release lock on the target database. */
@@ -1831,6 +1832,7 @@ dropdb(const char *dbname, bool missing_ok, bool force)
 	 * dirty buffer to the dead database later...
 	 */
 	DropDatabaseBuffers(db_id);
+	smgrforgetdatabasesizes(db_id);
 
 	/*
 	 * Tell checkpointer to forget any pending fsync and unlink requests for
@@ -2116,6 +2118,7 @@ movedb(const char *dbname, const char *tblspcname)
 	 * src_tblspcoid, but bufmgr.c presently provides no API for that.
 	 */
 	DropDatabaseBuffers(db_id);
+	smgrforgetdatabasesizes(db_id);
 
 	/*
 	 * Check for existence of files in the target directory, i.e., objects of
@@ -3405,6 +3408,7 @@ dbase_redo(XLogReaderState *record)
 
 		/* Drop pages for this database that are in the shared buffer cache */
 		DropDatabaseBuffers(xlrec->db_id);
+		smgrforgetdatabasesizes(xlrec->db_id);
 
 		/* Also, clean out any fsync requests that might be pending in md.c */
 		ForgetDatabaseSyncRequests(xlrec->db_id);
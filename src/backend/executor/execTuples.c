@@ -1042,6 +1042,33 @@ slot_deform_heap_tuple(TupleTableSlot *slot, HeapTuple tuple, uint32 *offp,
 
 	tp = (char *) tup + tup->t_hoff;
 
+	/*
+	 * Fast path for the leading run of non-null, fixed-width attributes whose
+	 * offsets have already been cached.  These are at the same offset in
+	 * every tuple of this descriptor, so there's no alignment or length
+	 * computation to do; just fetch them.  Wide tables usually start with
+	 * such a run (keys, timestamps, counters), and this loop is considerably
+	 * tighter than the general one below.  We stop at the first attribute
+	 * that doesn't qualify and let the general loop take over from there,
+	 * with "off" pointing just past the last attribute we fetched.
+	 */
+	if (!slow)
+	{
+		for (; attnum < natts; attnum++)
+		{
+			Form_pg_attribute thisatt = TupleDescAttr(tupleDesc, attnum);
+
+			if (thisatt->attcacheoff < 0 || thisatt->attlen <= 0)
+				break;
+			if (hasnulls && att_isnull(attnum, bp))
+				break;
+
+			values[attnum] = fetchatt(thisatt, tp + thisatt->attcacheoff);
+			isnull[attnum] = false;
+			off = thisatt->attcacheoff + thisatt->attlen;
+		}
+	}
+
 	for (; attnum < natts; attnum++)
 	{
 		Form_pg_attribute thisatt = TupleDescAttr(tupleDesc, attnum);
@@ -123,6 +123,11 @@ IndexOnlyNext(IndexOnlyScanState *node)
 
 		CHECK_FOR_INTERRUPTS();
 
+		/* Get the table blocks of the next few tuples on their way */
+		if (node->ioss_PrefetchMax > 0)
+			ExecIndexPrefetch(scandesc, direction, node->ioss_PrefetchTids,
+							  node->ioss_PrefetchMax, &node->ioss_VMBuffer);
+
 		/*
 		 * We can skip the heap fetch if the TID references a heap page on
 		 * which all tuples are known visible to everybody.  In any case,
@@ -587,6 +592,13 @@ ExecInitIndexOnlyScan(IndexOnlyScan *node, EState *estate, int eflags)
 	indexRelation = index_open(node->indexid, lockmode);
 	indexstate->ioss_RelationDesc = indexRelation;
 
+	/* Set up prefetching of table blocks, if possible */
+	indexstate->ioss_PrefetchMax =
+		ExecIndexPrefetchDistance(currentRelation, indexRelation);
+	if (indexstate->ioss_PrefetchMax > 0)
+		indexstate->ioss_PrefetchTids =
+			palloc(sizeof(ItemPointerData) * indexstate->ioss_PrefetchMax);
+
 	/*
 	 * Initialize index-specific scan state
 	 */
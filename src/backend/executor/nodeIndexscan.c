@@ -32,6 +32,8 @@
 #include "access/nbtree.h"
 #include "access/relscan.h"
 #include "access/tableam.h"
+#include "access/visibilitymap.h"
+#include "catalog/catalog.h"
 #include "catalog/pg_am.h"
 #include "executor/executor.h"
 #include "executor/nodeIndexscan.h"
@@ -42,6 +44,7 @@
 #include "utils/datum.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
+#include "utils/spccache.h"
 
 /*
  * When an ordering operator is used, tuples fetched from the index that
@@ -131,6 +134,11 @@ IndexNext(IndexScanState *node)
 	{
 		CHECK_FOR_INTERRUPTS();
 
+		/* Get the table blocks of the next few tuples on their way */
+		if (node->iss_PrefetchMax > 0)
+			ExecIndexPrefetch(scandesc, direction, node->iss_PrefetchTids,
+							  node->iss_PrefetchMax, NULL);
+
 		/*
 		 * If the index was lossy, we have to recheck the index quals using
 		 * the fetched tuple.
@@ -776,6 +784,61 @@ ExecIndexAdvanceArrayKeys(IndexArrayKeyInfo *arrayKeys, int numArrayKeys)
 	return found;
 }
 
+/*
+ * ExecIndexPrefetchDistance
+ *		Decide how many tuples ahead an index scan should prefetch.
+ *
+ * This requires both an index AM that can report upcoming TIDs and a table
+ * AM that can prefetch them.  Catalog scans are skipped, both because their
+ * data is almost always cached and to avoid circularity in looking up
+ * tablespace settings.  Returns 0 if prefetching is not to be done.
+ */
+int
+ExecIndexPrefetchDistance(Relation heapRelation, Relation indexRelation)
+{
+#ifdef USE_PREFETCH
+	if (indexRelation->rd_indam->amgetprefetchtids != NULL &&
+		heapRelation->rd_tableam->index_fetch_prefetch != NULL &&
+		!IsCatalogRelation(heapRelation))
+		return get_tablespace_io_concurrency(heapRelation->rd_rel->reltablespace);
+#endif
+	return 0;
+}
+
+/*
+ * ExecIndexPrefetch
+ *		Ask the table AM to prefetch the tuples the index scan returns next.
+ *
+ * tids must have room for maxtids entries.  For an index-only scan, vmbuffer
+ * is the scan's visibility map buffer, and tuples on all-visible pages are
+ * left out since they won't be fetched from the table; pass NULL otherwise.
+ */
+void
+ExecIndexPrefetch(IndexScanDesc scandesc, ScanDirection direction,
+				  ItemPointerData *tids, int maxtids, Buffer *vmbuffer)
+{
+	int			ntids;
+
+	ntids = index_getprefetchtids(scandesc, direction, tids, maxtids);
+
+	if (vmbuffer != NULL)
+	{
+		int			n = 0;
+
+		for (int i = 0; i < ntids; i++)
+		{
+			if (!VM_ALL_VISIBLE(scandesc->heapRelation,
+								ItemPointerGetBlockNumber(&tids[i]),
+								vmbuffer))
+				tids[n++] = tids[i];
+		}
+		ntids = n;
+	}
+
+	if (ntids > 0)
+		table_index_fetch_prefetch(scandesc->xs_heapfetch, tids, ntids);
+}
+
 
 /* ----------------------------------------------------------------
  *		ExecEndIndexScan
@@ -954,6 +1017,13 @@ ExecInitIndexScan(IndexScan *node, EState *estate, int eflags)
 	lockmode = exec_rt_fetch(node->scan.scanrelid, estate)->rellockmode;
 	indexstate->iss_RelationDesc = index_open(node->indexid, lockmode);
 
+	/* Set up prefetching of table blocks, if possible */
+	indexstate->iss_PrefetchMax =
+		ExecIndexPrefetchDistance(currentRelation, indexstate->iss_RelationDesc);
+	if (indexstate->iss_PrefetchMax > 0)
+		indexstate->iss_PrefetchTids =
+			palloc(sizeof(ItemPointerData) * indexstate->iss_PrefetchMax);
+
 	/*
 	 * Initialize index-specific scan state
 	 */
@@ -43,6 +43,7 @@
 #include "utils/resowner.h"
 
 #define LLVMJIT_LLVM_CONTEXT_REUSE_MAX 100
+#define LLVMJIT_LLVM_CONTEXT_REUSE_MAX_NOINLINE 1000
 
 /* Handle of a module emitted via ORC JIT */
 typedef struct LLVMJitHandle
@@ -89,6 +90,8 @@ static size_t llvm_jit_context_in_use_count = 0;
 
 /* how many times has the current LLVMContextRef been used */
 static size_t llvm_llvm_context_reuse_count = 0;
+/* has inlining been performed in the current LLVMContextRef */
+static bool llvm_llvm_context_inlined = false;
 static const char *llvm_triple = NULL;
 static const char *llvm_layout = NULL;
 static LLVMContextRef llvm_context;
@@ -160,11 +163,15 @@ _PG_jit_provider_init(JitProviderCallbacks *cb)
  * performed). To prevent that from slowly accumulating problematic amounts of
  * memory, recreate the LLVMContextRef we use. We don't want to do so too
  * often, as that implies some overhead (particularly re-loading the module
- * summaries / modules is fairly expensive). A future TODO would be to make
- * this more finegrained and only drop/recreate the LLVMContextRef when we know
- * there has been inlining. If we can get the size of the context from LLVM
- * then that might be a better way to determine when to drop/recreate rather
- * then the usagecount heuristic currently employed.
+ * summaries / modules is fairly expensive).
+ *
+ * Without inlining, the context only accumulates the constants uniqued for
+ * the code we generate, which grows far more slowly, so in that case we
+ * reuse the context for many more compilations; that avoids needlessly
+ * re-reading llvmjit_types.bc and re-creating the types derived from it.
+ * If we can get the size of the context from LLVM then that might be a
+ * better way to determine when to drop/recreate rather then the usagecount
+ * heuristic currently employed.
  */
 static void
 llvm_recreate_llvm_context(void)
@@ -182,7 +189,9 @@ llvm_recreate_llvm_context(void)
 		return;
 	}
 
-	if (llvm_llvm_context_reuse_count <= LLVMJIT_LLVM_CONTEXT_REUSE_MAX)
+	if (llvm_llvm_context_reuse_count <= LLVMJIT_LLVM_CONTEXT_REUSE_MAX ||
+		(!llvm_llvm_context_inlined &&
+		 llvm_llvm_context_reuse_count <= LLVMJIT_LLVM_CONTEXT_REUSE_MAX_NOINLINE))
 	{
 		llvm_llvm_context_reuse_count++;
 		return;
@@ -199,6 +208,7 @@ llvm_recreate_llvm_context(void)
 	LLVMContextDispose(llvm_context);
 	llvm_context = LLVMContextCreate();
 	llvm_llvm_context_reuse_count = 0;
+	llvm_llvm_context_inlined = false;
 
 	/*
 	 * Re-build cached type information, so code generation code can rely on
@@ -716,6 +726,7 @@ llvm_compile_module(LLVMJitContext *context)
 	if (context->base.flags & PGJIT_INLINE)
 	{
 		INSTR_TIME_SET_CURRENT(starttime);
+		llvm_llvm_context_inlined = true;
 		llvm_inline(context->module);
 		INSTR_TIME_SET_CURRENT(endtime);
 		INSTR_TIME_ACCUM_DIFF(context->base.instr.inlining_counter,
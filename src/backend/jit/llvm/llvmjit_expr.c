@@ -49,6 +49,10 @@ typedef struct CompiledExprState
 {
 	LLVMJitContext *context;
 	const char *funcname;
+
+	/* evaluations left to run in the interpreter, see jit_warmup_evaluations */
+	int			warmup_remaining;
+	ExprStateEvalFunc interp_func;
 } CompiledExprState;
 
 
@@ -586,12 +590,16 @@ llvm_compile_expr(ExprState *state)
 
 			case EEOP_FUNCEXPR:
 			case EEOP_FUNCEXPR_STRICT:
+			case EEOP_FUNCEXPR_STRICT_1:
+			case EEOP_FUNCEXPR_STRICT_2:
 				{
 					FunctionCallInfo fcinfo = op->d.func.fcinfo_data;
 					LLVMValueRef v_fcinfo_isnull;
 					LLVMValueRef v_retval;
 
-					if (opcode == EEOP_FUNCEXPR_STRICT)
+					if (opcode == EEOP_FUNCEXPR_STRICT ||
+						opcode == EEOP_FUNCEXPR_STRICT_1 ||
+						opcode == EEOP_FUNCEXPR_STRICT_2)
 					{
 						LLVMBasicBlockRef b_nonull;
 						LLVMBasicBlockRef *b_checkargnulls;
@@ -2864,6 +2872,7 @@ llvm_compile_expr(ExprState *state)
 
 		cstate->context = context;
 		cstate->funcname = funcname;
+		cstate->warmup_remaining = jit_warmup_evaluations;
 
 		state->evalfunc = ExecRunCompiledExpr;
 		state->evalfunc_private = cstate;
@@ -2881,10 +2890,18 @@ llvm_compile_expr(ExprState *state)
 /*
  * Run compiled expression.
  *
- * This will only be called the first time a JITed expression is called. We
- * first make sure the expression is still up-to-date, and then get a pointer to
- * the emitted function. The latter can be the first thing that triggers
- * optimizing and emitting all the generated functions.
+ * Unless jit_warmup_evaluations is set, this will only be called the first
+ * time a JITed expression is called. We first make sure the expression is
+ * still up-to-date, and then get a pointer to the emitted function. The latter
+ * can be the first thing that triggers optimizing and emitting all the
+ * generated functions.
+ *
+ * With a warm-up count, the first that many evaluations are instead handed to
+ * the interpreter, so that expressions which turn out to be evaluated only a
+ * few times never pay for optimization and emission.  The interpreter's setup
+ * rewrites the steps for direct threading, which the generated code does not
+ * depend on, and replaces evalfunc / evalfunc_private; we capture the
+ * interpreter's entry point and put ourselves back in place.
  */
 static Datum
 ExecRunCompiledExpr(ExprState *state, ExprContext *econtext, bool *isNull)
@@ -2892,7 +2909,24 @@ ExecRunCompiledExpr(ExprState *state, ExprContext *econtext, bool *isNull)
 	CompiledExprState *cstate = state->evalfunc_private;
 	ExprStateEvalFunc func;
 
-	CheckExprStillValid(state, econtext);
+	if (cstate->warmup_remaining > 0)
+	{
+		if (cstate->interp_func == NULL)
+		{
+			CheckExprStillValid(state, econtext);
+
+			ExecReadyInterpretedExpr(state);
+			cstate->interp_func = (ExprStateEvalFunc) state->evalfunc_private;
+			state->evalfunc = ExecRunCompiledExpr;
+			state->evalfunc_private = cstate;
+		}
+
+		cstate->warmup_remaining--;
+		return cstate->interp_func(state, econtext, isNull);
+	}
+
+	if (cstate->interp_func == NULL)
+		CheckExprStillValid(state, econtext);
 
 	llvm_enter_fatal_on_oom();
 	func = (ExprStateEvalFunc) llvm_get_function(cstate->context,
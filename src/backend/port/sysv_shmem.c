@@ -26,6 +26,9 @@
 #include <sys/mman.h>
 #include <sys/shm.h>
 #include <sys/stat.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 #include "miscadmin.h"
 #include "port/pg_bitutils.h"
@@ -38,6 +41,23 @@
 #include "utils/guc_hooks.h"
 #include "utils/pidfile.h"
 
+/*
+ * NUMA memory policy support.  We issue the mbind() and get_mempolicy()
+ * system calls directly rather than depending on libnuma; the constants are
+ * part of the kernel ABI (see <linux/mempolicy.h>).
+ */
+#if defined(SYS_mbind) && defined(SYS_get_mempolicy)
+#define USE_SHMEM_NUMA_INTERLEAVE
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE			3
+#endif
+#ifndef MPOL_F_MEMS_ALLOWED
+#define MPOL_F_MEMS_ALLOWED		(1 << 2)
+#endif
+/* Largest node number the kernel can be configured for (NODES_SHIFT = 10) */
+#define SHMEM_NUMA_MAX_NODES	1024
+#endif
+
 
 /*
  * As of PostgreSQL 9.3, we normally allocate only a very small amount of
@@ -588,6 +608,77 @@ check_huge_page_size(int *newval, void **extra, GucSource source)
 	return true;
 }
 
+/*
+ * GUC check_hook for shared_memory_numa_interleave
+ */
+bool
+check_shared_memory_numa_interleave(bool *newval, void **extra,
+									GucSource source)
+{
+#ifndef USE_SHMEM_NUMA_INTERLEAVE
+	if (*newval)
+	{
+		GUC_check_errdetail("\"shared_memory_numa_interleave\" is not supported on this platform.");
+		return false;
+	}
+#endif
+	return true;
+}
+
+/*
+ * Spread the pages of a freshly mapped shared memory segment round-robin
+ * across all the NUMA nodes we are allowed to allocate memory on.
+ *
+ * Without this, each page lands on the node of whichever process first
+ * touches it, which tends to pile large parts of shared_buffers onto a
+ * single node and makes every other socket pay for remote accesses.  The
+ * policy is attached to the shared mapping itself, so it must be set before
+ * anything is written to the segment, and it applies to all backends.
+ *
+ * Failure is not fatal; we just fall back to the default policy.
+ */
+static void
+InterleaveSharedMemory(void *address, Size size)
+{
+#ifdef USE_SHMEM_NUMA_INTERLEAVE
+	unsigned long nodemask[SHMEM_NUMA_MAX_NODES / (8 * sizeof(unsigned long))];
+	int			nnodes = 0;
+
+	memset(nodemask, 0, sizeof(nodemask));
+	if (syscall(SYS_get_mempolicy, NULL, nodemask,
+				(unsigned long) SHMEM_NUMA_MAX_NODES, NULL,
+				MPOL_F_MEMS_ALLOWED) != 0)
+	{
+		ereport(LOG,
+				(errmsg("could not determine the NUMA nodes available for shared memory: %m")));
+		return;
+	}
+
+	for (int i = 0; i < lengthof(nodemask); i++)
+		nnodes += pg_popcount((const char *) &nodemask[i],
+							  sizeof(unsigned long));
+
+	/* Nothing to do on a machine with a single node */
+	if (nnodes < 2)
+		return;
+
+	/*
+	 * The kernel ignores the last bit of the node mask (historically an
+	 * off-by-one in its interface), so pass one more than the mask's size.
+	 */
+	if (syscall(SYS_mbind, address, size, MPOL_INTERLEAVE, nodemask,
+				(unsigned long) SHMEM_NUMA_MAX_NODES + 1, 0) != 0)
+	{
+		ereport(LOG,
+				(errmsg("could not interleave shared memory across NUMA nodes: %m")));
+		return;
+	}
+
+	elog(DEBUG1, "interleaved %zu bytes of shared memory across %d NUMA nodes",
+		 size, nnodes);
+#endif
+}
+
 /*
  * Creates an anonymous mmap()ed shared memory segment.
  *
@@ -663,6 +754,9 @@ CreateAnonymousSegment(Size *size)
 						 allocsize) : 0));
 	}
 
+	if (shared_memory_numa_interleave)
+		InterleaveSharedMemory(ptr, allocsize);
+
 	*size = allocsize;
 	return ptr;
 }
@@ -752,6 +846,11 @@ PGSharedMemoryCreate(Size size,
 		/* huge pages are only available with mmap */
 		SetConfigOption("huge_pages_status", "off",
 						PGC_INTERNAL, PGC_S_DYNAMIC_DEFAULT);
+
+		/* NUMA interleaving is only done for the anonymous segment, too */
+		if (shared_memory_numa_interleave)
+			ereport(LOG,
+					(errmsg("\"shared_memory_numa_interleave\" is ignored because \"shared_memory_type\" is not \"mmap\"")));
 	}
 
 	/*
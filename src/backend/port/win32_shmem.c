@@ -648,3 +648,18 @@ check_huge_page_size(int *newval, void **extra, GucSource source)
 	}
 	return true;
 }
+
+/*
+ * GUC check_hook for shared_memory_numa_interleave
+ */
+bool
+check_shared_memory_numa_interleave(bool *newval, void **extra,
+									GucSource source)
+{
+	if (*newval)
+	{
+		GUC_check_errdetail("\"shared_memory_numa_interleave\" is not supported on this platform.");
+		return false;
+	}
+	return true;
+}
@@ -30,7 +30,10 @@
  * read-ahead advice.  There is no benefit in looking ahead more than
  * io_combine_limit, because in this case the only goal is larger read system
  * calls.  Looking further ahead would pin many buffers and perform
- * speculative work for no benefit.
+ * speculative work for no benefit.  With direct I/O there is no kernel
+ * read-ahead to hide the latency of small reads either, so in that case we
+ * jump straight to io_combine_limit as soon as I/O is needed, instead of
+ * ramping up gradually.
  *
  * C) I/O is necessary, it appears to be random, and this system supports
  * read-ahead advice.  We'll look further ahead in order to reach the
@@ -115,6 +118,7 @@ struct ReadStream
 	int16		pinned_buffers;
 	int16		distance;
 	bool		advice_enabled;
+	bool		direct_io;
 
 	/*
 	 * One-block buffer to support 'ungetting' a block number, to resolve flow
@@ -500,6 +504,9 @@ read_stream_begin_impl(int flags,
 		stream->advice_enabled = true;
 #endif
 
+	/* Remember whether reads bypass the kernel page cache. */
+	stream->direct_io = (io_direct_flags & IO_DIRECT_DATA) != 0;
+
 	/*
 	 * For now, max_ios = 0 is interpreted as max_ios = 1 with advice disabled
 	 * above.  If we had real asynchronous I/O we might need a slightly
@@ -743,7 +750,14 @@ read_stream_next_buffer(ReadStream *stream, void **per_buffer_data)
 			}
 			else
 			{
-				distance = stream->distance * 2;
+				/*
+				 * Without kernel read-ahead, every small read is a full
+				 * round trip to the device, so don't bother ramping up.
+				 */
+				if (stream->direct_io)
+					distance = io_combine_limit;
+				else
+					distance = stream->distance * 2;
 				distance = Min(distance, io_combine_limit);
 				distance = Min(distance, stream->max_pinned_buffers);
 				stream->distance = distance;
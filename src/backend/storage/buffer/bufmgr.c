@@ -58,6 +58,7 @@
 #include "storage/smgr.h"
 #include "storage/standby.h"
 #include "utils/memdebug.h"
+#include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/rel.h"
 #include "utils/resowner.h"
@@ -211,6 +212,28 @@ static int32 PrivateRefCountOverflowed = 0;
 static uint32 PrivateRefCountClock = 0;
 static PrivateRefCountEntry *ReservedRefCountEntry = NULL;
 
+/*
+ * Backend-private cache of recent buffer mapping lookups:
+ *
+ * Looking up a block in the shared buffer mapping table requires acquiring
+ * one of the buffer mapping partition locks, even when the block is found.
+ * With many backends reading the same hot pages (index root pages, say), the
+ * cache lines holding those locks bounce between CPUs.  To avoid that, each
+ * backend remembers where it recently found blocks, in a small direct-mapped
+ * cache indexed by the tag's hash code.  Entries are merely hints: before
+ * using one, BufferAlloc() checks under the buffer header spinlock that the
+ * buffer still holds the block, so stale entries need no invalidation.
+ */
+#define RECENT_BUFFER_CACHE_SIZE 256	/* must be a power of 2 */
+
+typedef struct RecentBufferCacheEntry
+{
+	BufferTag	tag;
+	int			buf_id;
+} RecentBufferCacheEntry;
+
+static RecentBufferCacheEntry RecentBufferCache[RECENT_BUFFER_CACHE_SIZE];
+
 static void ReservePrivateRefCountEntry(void);
 static PrivateRefCountEntry *NewPrivateRefCountEntry(Buffer buffer);
 static PrivateRefCountEntry *GetPrivateRefCountEntry(Buffer buffer, bool do_move);
@@ -505,12 +528,16 @@ static BlockNumber ExtendBufferedRelShared(BufferManagerRelation bmr,
 										   uint32 *extended_by);
 static bool PinBuffer(BufferDesc *buf, BufferAccessStrategy strategy);
 static void PinBuffer_Locked(BufferDesc *buf);
+static bool PinRecentBuffer(BufferDesc *buf, const BufferTag *tag,
+							BufferAccessStrategy strategy);
 static void UnpinBuffer(BufferDesc *buf);
 static void UnpinBufferNoOwner(BufferDesc *buf);
 static void BufferSync(int flags);
 static uint32 WaitBufHdrUnlocked(BufferDesc *buf);
 static int	SyncOneBuffer(int buf_id, bool skip_recently_used,
 						  WritebackContext *wb_context);
+static int	SyncBufferRun(CkptSortItem *items, int nitems,
+						  WritebackContext *wb_context, int *nwritten);
 static void WaitIO(BufferDesc *buf);
 static bool StartBufferIO(BufferDesc *buf, bool forInput, bool nowait);
 static void TerminateBufferIO(BufferDesc *buf, bool clear_dirty,
@@ -1615,6 +1642,7 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 	Buffer		victim_buffer;
 	BufferDesc *victim_buf_hdr;
 	uint32		victim_buf_state;
+	RecentBufferCacheEntry *recent;
 
 	/* Make sure we will have room to remember the buffer pin */
 	ResourceOwnerEnlarge(CurrentResourceOwner);
@@ -1627,6 +1655,22 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 	newHash = BufTableHashCode(&newTag);
 	newPartitionLock = BufMappingPartitionLock(newHash);
 
+	/*
+	 * If we found the block recently, try the buffer it was in without
+	 * taking the mapping lock.
+	 */
+	recent = &RecentBufferCache[newHash & (RECENT_BUFFER_CACHE_SIZE - 1)];
+	if (BufferTagsEqual(&recent->tag, &newTag))
+	{
+		BufferDesc *buf = GetBufferDescriptor(recent->buf_id);
+
+		if (PinRecentBuffer(buf, &newTag, strategy))
+		{
+			*foundPtr = true;
+			return buf;
+		}
+	}
+
 	/* see if the block is in the buffer pool already */
 	LWLockAcquire(newPartitionLock, LW_SHARED);
 	existing_buf_id = BufTableLookup(&newTag, newHash);
@@ -1647,6 +1691,10 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 		/* Can release the mapping lock as soon as we've pinned it */
 		LWLockRelease(newPartitionLock);
 
+		/* Remember where we found it for next time */
+		recent->tag = newTag;
+		recent->buf_id = existing_buf_id;
+
 		*foundPtr = true;
 
 		if (!valid)
@@ -1747,7 +1795,7 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 	 * checkpoints, except for their "init" forks, which need to be treated
 	 * just like permanent relations.
 	 */
-	victim_buf_state |= BM_TAG_VALID | BUF_USAGECOUNT_ONE;
+	victim_buf_state |= BM_TAG_VALID | BM_REFERENCED | BUF_USAGECOUNT_ONE;
 	if (relpersistence == RELPERSISTENCE_PERMANENT || forkNum == INIT_FORKNUM)
 		victim_buf_state |= BM_PERMANENT;
 
@@ -1755,6 +1803,9 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 
 	LWLockRelease(newPartitionLock);
 
+	recent->tag = newTag;
+	recent->buf_id = victim_buf_hdr->buf_id;
+
 	/*
 	 * Buffer contents are currently invalid.
 	 */
@@ -2391,7 +2442,7 @@ ExtendBufferedRelShared(BufferManagerRelation bmr,
 
 			victim_buf_hdr->tag = tag;
 
-			buf_state |= BM_TAG_VALID | BUF_USAGECOUNT_ONE;
+			buf_state |= BM_TAG_VALID | BM_REFERENCED | BUF_USAGECOUNT_ONE;
 			if (bmr.relpersistence == RELPERSISTENCE_PERMANENT || fork == INIT_FORKNUM)
 				buf_state |= BM_PERMANENT;
 
@@ -2625,6 +2676,41 @@ ReleaseAndReadBuffer(Buffer buffer,
 	return ReadBuffer(relation, blockNum);
 }
 
+/*
+ * BufStateIncrementUsage -- account for a new pin in a buffer's usage count.
+ *
+ * Returns buf_state with the usage count adjusted as appropriate for a pin
+ * acquired with the given strategy.
+ */
+static inline uint32
+BufStateIncrementUsage(uint32 buf_state, BufferAccessStrategy strategy)
+{
+	if (strategy == NULL)
+	{
+		/*
+		 * Default case: increase usagecount unless already max, or already
+		 * increased since the clock sweep last visited the buffer.
+		 */
+		if ((buf_state & BM_REFERENCED) == 0)
+		{
+			if (BUF_STATE_GET_USAGECOUNT(buf_state) < BM_MAX_USAGE_COUNT)
+				buf_state += BUF_USAGECOUNT_ONE;
+			buf_state |= BM_REFERENCED;
+		}
+	}
+	else
+	{
+		/*
+		 * Ring buffers shouldn't evict others from pool.  Thus we don't make
+		 * usagecount more than 1.
+		 */
+		if (BUF_STATE_GET_USAGECOUNT(buf_state) == 0)
+			buf_state += BUF_USAGECOUNT_ONE;
+	}
+
+	return buf_state;
+}
+
 /*
  * PinBuffer -- make buffer unavailable for replacement.
  *
@@ -2675,24 +2761,9 @@ PinBuffer(BufferDesc *buf, BufferAccessStrategy strategy)
 
 			buf_state = old_buf_state;
 
-			/* increase refcount */
+			/* increase refcount and usagecount */
 			buf_state += BUF_REFCOUNT_ONE;
-
-			if (strategy == NULL)
-			{
-				/* Default case: increase usagecount unless already max. */
-				if (BUF_STATE_GET_USAGECOUNT(buf_state) < BM_MAX_USAGE_COUNT)
-					buf_state += BUF_USAGECOUNT_ONE;
-			}
-			else
-			{
-				/*
-				 * Ring buffers shouldn't evict others from pool.  Thus we
-				 * don't make usagecount more than 1.
-				 */
-				if (BUF_STATE_GET_USAGECOUNT(buf_state) == 0)
-					buf_state += BUF_USAGECOUNT_ONE;
-			}
+			buf_state = BufStateIncrementUsage(buf_state, strategy);
 
 			if (pg_atomic_compare_exchange_u32(&buf->state, &old_buf_state,
 											   buf_state))
@@ -2796,6 +2867,65 @@ PinBuffer_Locked(BufferDesc *buf)
 	ResourceOwnerRememberBuffer(CurrentResourceOwner, b);
 }
 
+/*
+ * PinRecentBuffer -- pin a buffer found in RecentBufferCache.
+ *
+ * Pins the buffer and returns true if it's valid and still holds the block
+ * identified by tag.  Otherwise returns false without pinning it, and the
+ * caller must look the block up in the buffer mapping table.
+ *
+ * As in ReadRecentBuffer(), we must check the tag before pinning, so that we
+ * never hold a pin on a random non-matching buffer, which could confuse code
+ * paths like InvalidateBuffer().  The caller must have called
+ * ResourceOwnerEnlarge() and ReservePrivateRefCountEntry().
+ */
+static bool
+PinRecentBuffer(BufferDesc *buf, const BufferTag *tag,
+				BufferAccessStrategy strategy)
+{
+	Buffer		b = BufferDescriptorGetBuffer(buf);
+	PrivateRefCountEntry *ref;
+	uint32		buf_state;
+
+	/*
+	 * If we already have it pinned, the tag can't change, so we can check it
+	 * without locking.
+	 */
+	if (GetPrivateRefCount(b) > 0)
+	{
+		buf_state = pg_atomic_read_u32(&buf->state);
+		if (!(buf_state & BM_VALID) || !BufferTagsEqual(&buf->tag, tag))
+			return false;
+		PinBuffer(buf, strategy);	/* bump pin count */
+		return true;
+	}
+
+	buf_state = LockBufHdr(buf);
+
+	if (!(buf_state & BM_VALID) || !BufferTagsEqual(&buf->tag, tag))
+	{
+		UnlockBufHdr(buf, buf_state);
+		return false;
+	}
+
+	/*
+	 * It's the right block.  Pin it and count the usage while we hold the
+	 * spinlock, like PinBuffer() would.
+	 */
+	VALGRIND_MAKE_MEM_DEFINED(BufHdrGetBlock(buf), BLCKSZ);
+
+	buf_state += BUF_REFCOUNT_ONE;
+	buf_state = BufStateIncrementUsage(buf_state, strategy);
+	UnlockBufHdr(buf, buf_state);
+
+	ref = NewPrivateRefCountEntry(b);
+	ref->refcount++;
+
+	ResourceOwnerRememberBuffer(CurrentResourceOwner, b);
+
+	return true;
+}
+
 /*
  * UnpinBuffer -- make buffer available for replacement.
  *
@@ -3097,43 +3227,71 @@ BufferSync(int flags)
 		BufferDesc *bufHdr = NULL;
 		CkptTsStatus *ts_stat = (CkptTsStatus *)
 			DatumGetPointer(binaryheap_first(ts_heap));
+		int			nprocessed;
 
 		buf_id = CkptBufferIds[ts_stat->index].buf_id;
 		Assert(buf_id != -1);
 
 		bufHdr = GetBufferDescriptor(buf_id);
 
-		num_processed++;
-
 		/*
 		 * We don't need to acquire the lock here, because we're only looking
 		 * at a single bit. It's possible that someone else writes the buffer
 		 * and clears the flag right after we check, but that doesn't matter
-		 * since SyncOneBuffer will then do nothing.  However, there is a
+		 * since SyncBufferRun will then do nothing.  However, there is a
 		 * further race condition: it's conceivable that between the time we
-		 * examine the bit here and the time SyncOneBuffer acquires the lock,
+		 * examine the bit here and the time SyncBufferRun acquires the lock,
 		 * someone else not only wrote the buffer but replaced it with another
-		 * page and dirtied it.  In that improbable case, SyncOneBuffer will
+		 * page and dirtied it.  In that improbable case, SyncBufferRun will
 		 * write the buffer though we didn't need to.  It doesn't seem worth
 		 * guarding against this, though.
 		 */
 		if (pg_atomic_read_u32(&bufHdr->state) & BM_CHECKPOINT_NEEDED)
 		{
-			if (SyncOneBuffer(buf_id, false, &wb_context) & BUF_WRITTEN)
+			CkptSortItem *items = &CkptBufferIds[ts_stat->index];
+			int			nitems = 1;
+			int			nwritten;
+
+			/*
+			 * The sort order places buffers for consecutive blocks of the
+			 * same relation fork next to each other.  Collect as many of them
+			 * as we can into a run, and let SyncBufferRun write them out
+			 * with a single vectored write.
+			 */
+			while (nitems < io_combine_limit &&
+				   nitems < ts_stat->num_to_scan - ts_stat->num_scanned)
 			{
-				TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(buf_id);
-				PendingCheckpointerStats.buffers_written++;
-				num_written++;
+				CkptSortItem *prev = &items[nitems - 1];
+				CkptSortItem *next = &items[nitems];
+
+				if (next->relNumber != prev->relNumber ||
+					next->forkNum != prev->forkNum ||
+					next->blockNum != prev->blockNum + 1 ||
+					!(pg_atomic_read_u32(&GetBufferDescriptor(next->buf_id)->state) &
+					  BM_CHECKPOINT_NEEDED))
+					break;
+				nitems++;
 			}
+
+			nprocessed = SyncBufferRun(items, nitems, &wb_context, &nwritten);
+
+			for (int j = 0; j < nwritten; j++)
+				TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(items[j].buf_id);
+			PendingCheckpointerStats.buffers_written += nwritten;
+			num_written += nwritten;
 		}
+		else
+			nprocessed = 1;
+
+		num_processed += nprocessed;
 
 		/*
 		 * Measure progress independent of actually having to flush the buffer
 		 * - otherwise writing become unbalanced.
 		 */
-		ts_stat->progress += ts_stat->progress_slice;
-		ts_stat->num_scanned++;
-		ts_stat->index++;
+		ts_stat->progress += ts_stat->progress_slice * nprocessed;
+		ts_stat->num_scanned += nprocessed;
+		ts_stat->index += nprocessed;
 
 		/* Have all the buffers from the tablespace been processed? */
 		if (ts_stat->num_scanned == ts_stat->num_to_scan)
@@ -3548,6 +3706,209 @@ SyncOneBuffer(int buf_id, bool skip_recently_used, WritebackContext *wb_context)
 	return result | BUF_WRITTEN;
 }
 
+/*
+ * SyncBufferRun -- write out a run of consecutive blocks during a checkpoint.
+ *
+ * items[] is a slice of the sorted CkptBufferIds array holding nitems entries
+ * for consecutive blocks of the same relation fork, as far as the caller
+ * could tell without locking anything.  We write out as many of them as we
+ * can with a single vectored write.  The first buffer is handled just like
+ * SyncOneBuffer would; for the following ones we stop at the first buffer
+ * that no longer holds the expected block, doesn't need writing anymore, or
+ * that we can't lock or start I/O on without waiting.
+ *
+ * Returns the number of items consumed, which is at least one.  *nwritten is
+ * set to the number of buffers written, which are the leading items[].
+ */
+static int
+SyncBufferRun(CkptSortItem *items, int nitems, WritebackContext *wb_context,
+			  int *nwritten)
+{
+	static char *copy_space = NULL;
+	BufferDesc *bufs[MAX_IO_COMBINE_LIMIT];
+	const void *blocks[MAX_IO_COMBINE_LIMIT];
+	BufferTag	first_tag;
+	ErrorContextCallback errcallback;
+	SMgrRelation reln;
+	XLogRecPtr	max_lsn = InvalidXLogRecPtr;
+	bool		permanent = false;
+	instr_time	io_start;
+	int			nbufs = 0;
+
+	Assert(nitems >= 1 && nitems <= io_combine_limit);
+
+	*nwritten = 0;
+
+	for (int i = 0; i < nitems; i++)
+	{
+		BufferDesc *bufHdr = GetBufferDescriptor(items[i].buf_id);
+		LWLock	   *content_lock = BufferDescriptorGetContentLock(bufHdr);
+		uint32		buf_state;
+
+		/* Make sure we can handle the pin */
+		ReservePrivateRefCountEntry();
+		ResourceOwnerEnlarge(CurrentResourceOwner);
+
+		/* See SyncOneBuffer for why checking without content lock is OK */
+		buf_state = LockBufHdr(bufHdr);
+
+		if (i == 0)
+			first_tag = bufHdr->tag;
+		else
+		{
+			BufferTag	expected = first_tag;
+
+			expected.blockNum += i;
+			if (!BufferTagsEqual(&bufHdr->tag, &expected) ||
+				!(buf_state & BM_CHECKPOINT_NEEDED))
+			{
+				UnlockBufHdr(bufHdr, buf_state);
+				break;
+			}
+		}
+
+		if (!(buf_state & BM_VALID) || !(buf_state & BM_DIRTY))
+		{
+			/* It's clean, so nothing to do */
+			UnlockBufHdr(bufHdr, buf_state);
+			break;
+		}
+
+		PinBuffer_Locked(bufHdr);
+
+		/*
+		 * Only the first buffer may wait for the content lock and for a
+		 * concurrent I/O to finish.  Waiting while already holding locks and
+		 * I/O on earlier buffers of the run would risk deadlocks, and isn't
+		 * worth it anyway: we can write the rest of the run separately.
+		 */
+		if (i == 0)
+			LWLockAcquire(content_lock, LW_SHARED);
+		else if (!LWLockConditionalAcquire(content_lock, LW_SHARED))
+		{
+			UnpinBuffer(bufHdr);
+			break;
+		}
+
+		if (!StartBufferIO(bufHdr, false, i > 0))
+		{
+			/* someone else flushed it before we could */
+			LWLockRelease(content_lock);
+			UnpinBuffer(bufHdr);
+			break;
+		}
+
+		bufs[nbufs++] = bufHdr;
+	}
+
+	if (nbufs == 0)
+		return 1;
+
+	/* Setup error traceback support for ereport() */
+	errcallback.callback = shared_buffer_write_error_callback;
+	errcallback.arg = bufs[0];
+	errcallback.previous = error_context_stack;
+	error_context_stack = &errcallback;
+
+	reln = smgropen(BufTagGetRelFileLocator(&first_tag), INVALID_PROC_NUMBER);
+
+	for (int i = 0; i < nbufs; i++)
+	{
+		uint32		buf_state;
+		XLogRecPtr	recptr;
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_START(BufTagGetForkNum(&first_tag),
+											first_tag.blockNum + i,
+											reln->smgr_rlocator.locator.spcOid,
+											reln->smgr_rlocator.locator.dbOid,
+											reln->smgr_rlocator.locator.relNumber);
+
+		/* As in FlushBuffer, read the LSN while holding the header lock */
+		buf_state = LockBufHdr(bufs[i]);
+		recptr = BufferGetLSN(bufs[i]);
+		buf_state &= ~BM_JUST_DIRTIED;
+		UnlockBufHdr(bufs[i], buf_state);
+
+		if (buf_state & BM_PERMANENT)
+		{
+			permanent = true;
+			if (recptr > max_lsn)
+				max_lsn = recptr;
+		}
+	}
+
+	/* Enforce the WAL-before-data rule for the whole run at once */
+	if (permanent)
+		XLogFlush(max_lsn);
+
+	/*
+	 * Update page checksums if desired.  PageSetChecksumCopy() has room for
+	 * just one page, so we need our own copy space for a whole run.
+	 */
+	if (DataChecksumsEnabled())
+	{
+		if (copy_space == NULL)
+			copy_space = MemoryContextAllocAligned(TopMemoryContext,
+												   MAX_IO_COMBINE_LIMIT * BLCKSZ,
+												   PG_IO_ALIGN_SIZE,
+												   0);
+
+		for (int i = 0; i < nbufs; i++)
+		{
+			char	   *copy = copy_space + (Size) i * BLCKSZ;
+
+			memcpy(copy, BufHdrGetBlock(bufs[i]), BLCKSZ);
+			PageSetChecksumInplace((Page) copy, first_tag.blockNum + i);
+			blocks[i] = copy;
+		}
+	}
+	else
+	{
+		for (int i = 0; i < nbufs; i++)
+			blocks[i] = BufHdrGetBlock(bufs[i]);
+	}
+
+	io_start = pgstat_prepare_io_time(track_io_timing);
+
+	smgrwritev(reln,
+			   BufTagGetForkNum(&first_tag),
+			   first_tag.blockNum,
+			   blocks,
+			   nbufs,
+			   false);
+
+	pgstat_count_io_op_time(IOOBJECT_RELATION, IOCONTEXT_NORMAL,
+							IOOP_WRITE, io_start, nbufs);
+
+	pgBufferUsage.shared_blks_written += nbufs;
+
+	for (int i = 0; i < nbufs; i++)
+	{
+		BufferTag	tag = bufs[i]->tag;
+
+		TerminateBufferIO(bufs[i], true, 0, true);
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_DONE(BufTagGetForkNum(&tag),
+										   tag.blockNum,
+										   reln->smgr_rlocator.locator.spcOid,
+										   reln->smgr_rlocator.locator.dbOid,
+										   reln->smgr_rlocator.locator.relNumber);
+
+		LWLockRelease(BufferDescriptorGetContentLock(bufs[i]));
+		UnpinBuffer(bufs[i]);
+
+		/* Only checkpointer calls this, so IOContext is IOCONTEXT_NORMAL */
+		ScheduleBufferTagForWriteback(wb_context, IOCONTEXT_NORMAL, &tag);
+	}
+
+	/* Pop the error context stack */
+	error_context_stack = errcallback.previous;
+
+	*nwritten = nbufs;
+
+	return nbufs;
+}
+
 /*
  *		AtEOXact_Buffers - clean up at end of transaction.
  *
@@ -320,12 +320,21 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state, bool *from_r
 		/*
 		 * If the buffer is pinned or has a nonzero usage_count, we cannot use
 		 * it; decrement the usage_count (unless pinned) and keep scanning.
+		 * If it has been used since we last came by, just clear
+		 * BM_REFERENCED instead, so that its usage_count can be increased
+		 * again.
 		 */
 		local_buf_state = LockBufHdr(buf);
 
 		if (BUF_STATE_GET_REFCOUNT(local_buf_state) == 0)
 		{
-			if (BUF_STATE_GET_USAGECOUNT(local_buf_state) != 0)
+			if (local_buf_state & BM_REFERENCED)
+			{
+				local_buf_state &= ~BM_REFERENCED;
+
+				trycounter = NBuffers;
+			}
+			else if (BUF_STATE_GET_USAGECOUNT(local_buf_state) != 0)
 			{
 				local_buf_state -= BUF_USAGECOUNT_ONE;
 
@@ -67,6 +67,12 @@
 
 #define UINT32_ACCESS_ONCE(var)		 ((uint32)(*((volatile uint32 *)&(var))))
 
+/*
+ * Number of ProcGlobal->xids entries GetSnapshotData() checks at a time, to
+ * skip quickly over backends that have no XID assigned.
+ */
+#define SNAPSHOT_XID_SKIP_BLOCK	8
+
 /* Our shared memory area */
 typedef struct ProcArrayStruct
 {
@@ -2272,10 +2278,33 @@ GetSnapshotData(Snapshot snapshot)
 		 */
 		for (int pgxactoff = 0; pgxactoff < numProcs; pgxactoff++)
 		{
-			/* Fetch xid just once - see GetNewTransactionId */
-			TransactionId xid = UINT32_ACCESS_ONCE(other_xids[pgxactoff]);
+			TransactionId xid;
 			uint8		statusFlags;
 
+			/*
+			 * With many connections, most backends have no XID assigned at
+			 * any given moment.  Check a block of entries at a time and skip
+			 * it as a whole if it's empty, to keep the time we spend walking
+			 * the array while holding ProcArrayLock down.
+			 */
+			if (pgxactoff % SNAPSHOT_XID_SKIP_BLOCK == 0 &&
+				pgxactoff + SNAPSHOT_XID_SKIP_BLOCK <= numProcs)
+			{
+				TransactionId any_xid = InvalidTransactionId;
+
+				for (int i = 0; i < SNAPSHOT_XID_SKIP_BLOCK; i++)
+					any_xid |= UINT32_ACCESS_ONCE(other_xids[pgxactoff + i]);
+
+				if (any_xid == InvalidTransactionId)
+				{
+					pgxactoff += SNAPSHOT_XID_SKIP_BLOCK - 1;
+					continue;
+				}
+			}
+
+			/* Fetch xid just once - see GetNewTransactionId */
+			xid = UINT32_ACCESS_ONCE(other_xids[pgxactoff]);
+
 			Assert(allProcs[arrayP->pgprocnos[pgxactoff]].pgxactoff == pgxactoff);
 
 			/*
@@ -815,29 +815,31 @@ LWLockAttemptLock(LWLock *lock, LWLockMode mode)
 		}
 
 		/*
-		 * Attempt to swap in the state we are expecting. If we didn't see
-		 * lock to be free, that's just the old value. If we saw it as free,
-		 * we'll attempt to mark it acquired. The reason that we always swap
-		 * in the value is that this doubles as a memory barrier. We could try
-		 * to be smarter and only swap in values if we saw the lock as free,
-		 * but benchmark haven't shown it as beneficial so far.
-		 *
-		 * Retry if the value changed since we last looked at it.
+		 * If we didn't see the lock as free, give up without writing to the
+		 * lock's cache line.  With many backends contending for a hot lock,
+		 * swapping the unchanged value back in just to fail would take the
+		 * line in exclusive mode each time, bouncing it between cores (and
+		 * sockets) and slowing down the holder's release.  No memory barrier
+		 * is needed on this path: a caller that goes on to wait re-checks
+		 * after queueing itself, which involves atomic operations that act as
+		 * full barriers.
+		 */
+		if (!lock_free)
+			return true;		/* somebody else has the lock */
+
+		/*
+		 * Attempt to swap in the state we are expecting, marking the lock as
+		 * acquired.  Retry if the value changed since we last looked at it.
 		 */
 		if (pg_atomic_compare_exchange_u32(&lock->state,
 										   &old_state, desired_state))
 		{
-			if (lock_free)
-			{
-				/* Great! Got the lock. */
+			/* Great! Got the lock. */
 #ifdef LOCK_DEBUG
-				if (mode == LW_EXCLUSIVE)
-					lock->owner = MyProc;
+			if (mode == LW_EXCLUSIVE)
+				lock->owner = MyProc;
 #endif
-				return false;
-			}
-			else
-				return true;	/* somebody else has the lock */
+			return false;
 		}
 	}
 	pg_unreachable();
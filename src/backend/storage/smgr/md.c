@@ -1790,6 +1790,51 @@ mdsyncfiletag(const FileTag *ftag, char *path)
 	return result;
 }
 
+/*
+ * Ask the kernel to start writing back a file, given a file tag.  This is
+ * just a hint issued before the file is synced with mdsyncfiletag(), so
+ * errors are ignored.
+ */
+void
+mdflushfiletag(const FileTag *ftag)
+{
+	SMgrRelation reln;
+	File		file;
+	bool		need_to_close;
+	off_t		size;
+
+	/* Nothing to do if writes bypass the kernel's page cache */
+	if (io_direct_flags & IO_DIRECT_DATA)
+		return;
+
+	reln = smgropen(ftag->rlocator, INVALID_PROC_NUMBER);
+
+	/* See if we already have the file open, or need to open it. */
+	if (ftag->segno < reln->md_num_open_segs[ftag->forknum])
+	{
+		file = reln->md_seg_fds[ftag->forknum][ftag->segno].mdfd_vfd;
+		need_to_close = false;
+	}
+	else
+	{
+		char	   *p;
+
+		p = _mdfd_segpath(reln, ftag->forknum, ftag->segno);
+		file = PathNameOpenFile(p, _mdfd_open_flags());
+		pfree(p);
+		if (file < 0)
+			return;
+		need_to_close = true;
+	}
+
+	size = FileSize(file);
+	if (size > 0)
+		FileWriteback(file, 0, size, WAIT_EVENT_DATA_FILE_FLUSH);
+
+	if (need_to_close)
+		FileClose(file);
+}
+
 /*
  * Unlink a file, given a file tag.  Write the path into an output
  * buffer so the caller can use it in error messages.
@@ -40,6 +40,10 @@
  * themselves, as there could pointers to them in active use.  See
  * smgrrelease() and smgrreleaseall().
  *
+ * Relation sizes are also cached in shared memory, so that smgrnblocks()
+ * doesn't need to ask the kernel each time.  See "Shared relation size
+ * cache" below.
+ *
  * Portions Copyright (c) 1996-2024, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
  *
@@ -52,11 +56,15 @@
 #include "postgres.h"
 
 #include "access/xlogutils.h"
+#include "common/hashfn.h"
 #include "lib/ilist.h"
+#include "port/atomics.h"
 #include "storage/bufmgr.h"
 #include "storage/ipc.h"
 #include "storage/md.h"
+#include "storage/shmem.h"
 #include "storage/smgr.h"
+#include "storage/spin.h"
 #include "utils/hsearch.h"
 #include "utils/inval.h"
 
@@ -140,9 +148,53 @@ static HTAB *SMgrRelationHash = NULL;
 
 static dlist_head unpinned_relns;
 
+/*
+ * Shared relation size cache.
+ *
+ * Asking the kernel for the size of a relation fork means an lseek() call
+ * for each call to smgrnblocks(), which adds up when planning queries that
+ * touch many relations.  So we remember the sizes of recently used forks of
+ * non-temporary relations in a small direct-mapped table in shared memory.
+ *
+ * An entry is valid only as long as every change to the fork's size is
+ * reported to it.  All such changes go through smgrextend(),
+ * smgrzeroextend(), smgrtruncate() and smgrdounlinkall(), which update or
+ * invalidate the entry; smgrcreate() invalidates it too, in case the
+ * relfilenumber is reused.  Whole databases are copied and removed without
+ * going through smgr, so dbcommands.c calls smgrforgetdatabasesizes() for
+ * those.
+ *
+ * Readers don't take any lock.  Each slot has a change counter that is odd
+ * while the slot is being modified, and readers retry the kernel instead if
+ * it changed while they were reading.  Modifications are serialized by a
+ * per-slot spinlock.  When smgrnblocks() has to ask the kernel, it installs
+ * the result only if nobody modified the slot in the meantime; otherwise a
+ * concurrent extension could be overwritten with an older size.
+ */
+#define SMGR_SIZE_CACHE_SLOTS 8192	/* must be a power of 2 */
+
+typedef struct SMgrSizeCacheSlot
+{
+	slock_t		mutex;			/* serializes modifications */
+	pg_atomic_uint32 changecount;	/* odd while being modified */
+	RelFileLocator locator;
+	ForkNumber	forknum;
+	BlockNumber nblocks;		/* InvalidBlockNumber if unused */
+} SMgrSizeCacheSlot;
+
+static SMgrSizeCacheSlot *SMgrSizeCache = NULL;
+
 /* local function prototypes */
 static void smgrshutdown(int code, Datum arg);
 static void smgrdestroy(SMgrRelation reln);
+static SMgrSizeCacheSlot *smgrsizecacheslot(SMgrRelation reln,
+											ForkNumber forknum);
+static BlockNumber smgrsizecachelookup(SMgrRelation reln, ForkNumber forknum,
+									   uint32 *changecount);
+static void smgrsizecacheinstall(SMgrRelation reln, ForkNumber forknum,
+								 BlockNumber nblocks, uint32 changecount);
+static void smgrsizecacheupdate(SMgrRelation reln, ForkNumber forknum,
+								BlockNumber nblocks, bool extend);
 
 
 /*
@@ -414,6 +466,9 @@ void
 smgrcreate(SMgrRelation reln, ForkNumber forknum, bool isRedo)
 {
 	smgrsw[reln->smgr_which].smgr_create(reln, forknum, isRedo);
+
+	/* Forget any size remembered for a previous user of the relfilenumber */
+	smgrsizecacheupdate(reln, forknum, InvalidBlockNumber, false);
 }
 
 /*
@@ -518,7 +573,10 @@ smgrdounlinkall(SMgrRelation *rels, int nrels, bool isRedo)
 		int			which = rels[i]->smgr_which;
 
 		for (forknum = 0; forknum <= MAX_FORKNUM; forknum++)
+		{
 			smgrsw[which].smgr_unlink(rlocators[i], forknum, isRedo);
+			smgrsizecacheupdate(rels[i], forknum, InvalidBlockNumber, false);
+		}
 	}
 
 	pfree(rlocators);
@@ -550,6 +608,8 @@ smgrextend(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
 		reln->smgr_cached_nblocks[forknum] = blocknum + 1;
 	else
 		reln->smgr_cached_nblocks[forknum] = InvalidBlockNumber;
+
+	smgrsizecacheupdate(reln, forknum, blocknum + 1, true);
 }
 
 /*
@@ -575,6 +635,8 @@ smgrzeroextend(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
 		reln->smgr_cached_nblocks[forknum] = blocknum + nblocks;
 	else
 		reln->smgr_cached_nblocks[forknum] = InvalidBlockNumber;
+
+	smgrsizecacheupdate(reln, forknum, blocknum + nblocks, true);
 }
 
 /*
@@ -677,15 +739,25 @@ BlockNumber
 smgrnblocks(SMgrRelation reln, ForkNumber forknum)
 {
 	BlockNumber result;
+	uint32		changecount;
 
 	/* Check and return if we get the cached value for the number of blocks. */
 	result = smgrnblocks_cached(reln, forknum);
 	if (result != InvalidBlockNumber)
 		return result;
 
+	/* Then try the shared cache. */
+	result = smgrsizecachelookup(reln, forknum, &changecount);
+	if (result != InvalidBlockNumber)
+	{
+		reln->smgr_cached_nblocks[forknum] = result;
+		return result;
+	}
+
 	result = smgrsw[reln->smgr_which].smgr_nblocks(reln, forknum);
 
 	reln->smgr_cached_nblocks[forknum] = result;
+	smgrsizecacheinstall(reln, forknum, result, changecount);
 
 	return result;
 }
@@ -760,6 +832,9 @@ smgrtruncate(SMgrRelation reln, ForkNumber *forknum, int nforks, BlockNumber *nb
 		 * outright wrong until then.
 		 */
 		reln->smgr_cached_nblocks[forknum[i]] = nblocks[i];
+
+		/* The shared cache has no such invalidation, so update it now. */
+		smgrsizecacheupdate(reln, forknum[i], nblocks[i], false);
 	}
 }
 
@@ -841,3 +916,210 @@ ProcessBarrierSmgrRelease(void)
 	smgrreleaseall();
 	return true;
 }
+
+/*
+ * SMgrShmemSize() -- Report shared memory space needed by smgr.c
+ */
+Size
+SMgrShmemSize(void)
+{
+	return mul_size(SMGR_SIZE_CACHE_SLOTS, sizeof(SMgrSizeCacheSlot));
+}
+
+/*
+ * SMgrShmemInit() -- Allocate and initialize the shared relation size cache
+ */
+void
+SMgrShmemInit(void)
+{
+	bool		found;
+
+	SMgrSizeCache = (SMgrSizeCacheSlot *)
+		ShmemInitStruct("Relation Size Cache", SMgrShmemSize(), &found);
+
+	if (!found)
+	{
+		for (int i = 0; i < SMGR_SIZE_CACHE_SLOTS; i++)
+		{
+			SMgrSizeCacheSlot *slot = &SMgrSizeCache[i];
+
+			SpinLockInit(&slot->mutex);
+			pg_atomic_init_u32(&slot->changecount, 0);
+			slot->nblocks = InvalidBlockNumber;
+		}
+	}
+}
+
+/*
+ * smgrforgetdatabasesizes() -- Forget cached sizes of a database's relations
+ *
+ * This must be called when the files of a database are removed or moved to
+ * another tablespace without going through smgr.
+ */
+void
+smgrforgetdatabasesizes(Oid dbid)
+{
+	for (int i = 0; i < SMGR_SIZE_CACHE_SLOTS; i++)
+	{
+		SMgrSizeCacheSlot *slot = &SMgrSizeCache[i];
+
+		/*
+		 * Nobody can be using the database's relations concurrently, so an
+		 * unlocked pre-check is good enough.
+		 */
+		if (slot->locator.dbOid != dbid)
+			continue;
+
+		SpinLockAcquire(&slot->mutex);
+		pg_atomic_fetch_add_u32(&slot->changecount, 1);
+		if (slot->locator.dbOid == dbid)
+			slot->nblocks = InvalidBlockNumber;
+		pg_atomic_fetch_add_u32(&slot->changecount, 1);
+		SpinLockRelease(&slot->mutex);
+	}
+}
+
+/*
+ * Find the shared size cache slot for a relation fork, or NULL if its size
+ * can't be cached.
+ */
+static SMgrSizeCacheSlot *
+smgrsizecacheslot(SMgrRelation reln, ForkNumber forknum)
+{
+	struct
+	{
+		RelFileLocator locator;
+		ForkNumber	forknum;
+	}			key;
+	uint32		hash;
+
+	/* Temporary relations are private to a backend, and not worth it. */
+	if (SmgrIsTemp(reln) || SMgrSizeCache == NULL)
+		return NULL;
+
+	key.locator = reln->smgr_rlocator.locator;
+	key.forknum = forknum;
+	hash = hash_bytes((const unsigned char *) &key, sizeof(key));
+
+	return &SMgrSizeCache[hash & (SMGR_SIZE_CACHE_SLOTS - 1)];
+}
+
+/*
+ * Look up the size of a relation fork in the shared cache.
+ *
+ * Returns InvalidBlockNumber if it isn't cached.  In that case,
+ * *changecount is set to a value to pass to smgrsizecacheinstall().
+ */
+static BlockNumber
+smgrsizecachelookup(SMgrRelation reln, ForkNumber forknum,
+					uint32 *changecount)
+{
+	SMgrSizeCacheSlot *slot = smgrsizecacheslot(reln, forknum);
+	uint32		before;
+	uint32		after;
+	RelFileLocator locator;
+	ForkNumber	slot_forknum;
+	BlockNumber nblocks;
+
+	/* An odd value is never matched by smgrsizecacheinstall() */
+	*changecount = 1;
+
+	if (slot == NULL)
+		return InvalidBlockNumber;
+
+	before = pg_atomic_read_u32(&slot->changecount);
+	if (before & 1)
+		return InvalidBlockNumber;
+
+	pg_read_barrier();
+	locator = slot->locator;
+	slot_forknum = slot->forknum;
+	nblocks = slot->nblocks;
+	pg_read_barrier();
+
+	after = pg_atomic_read_u32(&slot->changecount);
+	if (after != before)
+		return InvalidBlockNumber;
+
+	*changecount = before;
+
+	if (nblocks == InvalidBlockNumber ||
+		slot_forknum != forknum ||
+		!RelFileLocatorEquals(locator, reln->smgr_rlocator.locator))
+		return InvalidBlockNumber;
+
+	return nblocks;
+}
+
+/*
+ * Remember the size of a relation fork that we got from the kernel, unless
+ * the slot was modified since smgrsizecachelookup() returned changecount.
+ */
+static void
+smgrsizecacheinstall(SMgrRelation reln, ForkNumber forknum,
+					 BlockNumber nblocks, uint32 changecount)
+{
+	SMgrSizeCacheSlot *slot = smgrsizecacheslot(reln, forknum);
+
+	if (slot == NULL || (changecount & 1))
+		return;
+
+	SpinLockAcquire(&slot->mutex);
+	if (pg_atomic_read_u32(&slot->changecount) == changecount)
+	{
+		pg_atomic_fetch_add_u32(&slot->changecount, 1);
+		slot->locator = reln->smgr_rlocator.locator;
+		slot->forknum = forknum;
+		slot->nblocks = nblocks;
+		pg_atomic_fetch_add_u32(&slot->changecount, 1);
+	}
+	SpinLockRelease(&slot->mutex);
+}
+
+/*
+ * Report a change in the size of a relation fork to the shared cache.
+ *
+ * If extend is true, the fork has been extended to at least nblocks blocks.
+ * Otherwise its size is now exactly nblocks, or unknown if nblocks is
+ * InvalidBlockNumber.  Either way we advance the slot's change counter, so
+ * that a concurrent smgrnblocks() doesn't install a size it got from the
+ * kernel before the change.
+ */
+static void
+smgrsizecacheupdate(SMgrRelation reln, ForkNumber forknum,
+					BlockNumber nblocks, bool extend)
+{
+	SMgrSizeCacheSlot *slot = smgrsizecacheslot(reln, forknum);
+	bool		match;
+
+	if (slot == NULL)
+		return;
+
+	SpinLockAcquire(&slot->mutex);
+	pg_atomic_fetch_add_u32(&slot->changecount, 1);
+
+	match = slot->nblocks != InvalidBlockNumber &&
+		slot->forknum == forknum &&
+		RelFileLocatorEquals(slot->locator, reln->smgr_rlocator.locator);
+
+	if (extend)
+	{
+		/*
+		 * Only adjust an existing entry.  Installing a new one would rely on
+		 * the caller having extended the fork exactly from its end.
+		 */
+		if (match && slot->nblocks < nblocks)
+			slot->nblocks = nblocks;
+	}
+	else if (nblocks != InvalidBlockNumber)
+	{
+		slot->locator = reln->smgr_rlocator.locator;
+		slot->forknum = forknum;
+		slot->nblocks = nblocks;
+	}
+	else if (match)
+		slot->nblocks = InvalidBlockNumber;
+
+	pg_atomic_fetch_add_u32(&slot->changecount, 1);
+	SpinLockRelease(&slot->mutex);
+}
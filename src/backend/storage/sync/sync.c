@@ -84,6 +84,7 @@ static CycleCtr checkpoint_cycle_ctr = 0;
 typedef struct SyncOps
 {
 	int			(*sync_syncfiletag) (const FileTag *ftag, char *path);
+	void		(*sync_flushfiletag) (const FileTag *ftag);	/* may be NULL */
 	int			(*sync_unlinkfiletag) (const FileTag *ftag, char *path);
 	bool		(*sync_filetagmatches) (const FileTag *ftag,
 										const FileTag *candidate);
@@ -96,6 +97,9 @@ static const SyncOps syncsw[] = {
 	/* magnetic disk */
 	[SYNC_HANDLER_MD] = {
 		.sync_syncfiletag = mdsyncfiletag,
+#ifdef HAVE_SYNC_FILE_RANGE
+		.sync_flushfiletag = mdflushfiletag,
+#endif
 		.sync_unlinkfiletag = mdunlinkfiletag,
 		.sync_filetagmatches = mdfiletagmatches
 	},
@@ -358,8 +362,40 @@ ProcessSyncRequests(void)
 	/* Set flag to detect failure if we don't reach the end of the loop */
 	sync_in_progress = true;
 
-	/* Now scan the hashtable for fsync requests to process */
 	absorb_counter = FSYNCS_PER_ABSORB;
+
+	/*
+	 * The fsyncs below are issued one at a time, so on their own they would
+	 * keep the devices holding the files (for instance, tablespaces on
+	 * separate volumes) busy only one after another.  Before the first one,
+	 * ask the kernel to start writing back all the files we're about to
+	 * sync, so that writeback proceeds on all devices concurrently and the
+	 * fsyncs mostly wait for writes that are already in flight.  We only do
+	 * this where the kernel can start writeback without side effects; the
+	 * fallback methods of pg_flush_data() either discard clean cached data
+	 * or are too expensive for whole files.
+	 */
+	if (enableFsync)
+	{
+		hash_seq_init(&hstat, pendingOps);
+		while ((entry = (PendingFsyncEntry *) hash_seq_search(&hstat)) != NULL)
+		{
+			if (entry->cycle_ctr == sync_cycle_ctr || entry->canceled ||
+				syncsw[entry->tag.handler].sync_flushfiletag == NULL)
+				continue;
+
+			syncsw[entry->tag.handler].sync_flushfiletag(&entry->tag);
+
+			/* Keep absorbing requests, as in the loop below */
+			if (--absorb_counter <= 0)
+			{
+				AbsorbSyncRequests();
+				absorb_counter = FSYNCS_PER_ABSORB;
+			}
+		}
+	}
+
+	/* Now scan the hashtable for fsync requests to process */
 	hash_seq_init(&hstat, pendingOps);
 	while ((entry = (PendingFsyncEntry *) hash_seq_search(&hstat)) != NULL)
 	{
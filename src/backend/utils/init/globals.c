@@ -158,8 +158,8 @@ bool		VacuumCostActive = false;
 
 /* configurable SLRU buffer sizes */
 int			commit_timestamp_buffers = 0;
-int			multixact_member_buffers = 32;
-int			multixact_offset_buffers = 16;
+int			multixact_member_buffers = 0;
+int			multixact_offset_buffers = 0;
 int			notify_buffers = 16;
 int			serializable_buffers = 32;
 int			subtransaction_buffers = 0;
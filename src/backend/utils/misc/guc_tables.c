@@ -561,6 +561,7 @@ static int	ssl_renegotiation_limit;
  */
 int			huge_pages = HUGE_PAGES_TRY;
 int			huge_page_size;
+bool		shared_memory_numa_interleave = false;
 static int	huge_pages_status = HUGE_PAGES_UNKNOWN;
 
 /*
@@ -2049,6 +2050,16 @@ struct config_bool ConfigureNamesBool[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"shared_memory_numa_interleave", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Interleaves the main shared memory segment across NUMA nodes."),
+			NULL
+		},
+		&shared_memory_numa_interleave,
+		false,
+		check_shared_memory_numa_interleave, NULL, NULL
+	},
+
 	{
 		{"data_sync_retry", PGC_POSTMASTER, ERROR_HANDLING_OPTIONS,
 			gettext_noop("Whether to continue running after a failure to sync data files."),
@@ -2386,22 +2397,22 @@ struct config_int ConfigureNamesInt[] =
 	{
 		{"multixact_member_buffers", PGC_POSTMASTER, RESOURCES_MEM,
 			gettext_noop("Sets the size of the dedicated buffer pool used for the MultiXact member cache."),
-			NULL,
+			gettext_noop("Specify 0 to have this value determined as a fraction of \"shared_buffers\"."),
 			GUC_UNIT_BLOCKS
 		},
 		&multixact_member_buffers,
-		32, 16, SLRU_MAX_ALLOWED_BUFFERS,
+		0, 0, SLRU_MAX_ALLOWED_BUFFERS,
 		check_multixact_member_buffers, NULL, NULL
 	},
 
 	{
 		{"multixact_offset_buffers", PGC_POSTMASTER, RESOURCES_MEM,
 			gettext_noop("Sets the size of the dedicated buffer pool used for the MultiXact offset cache."),
-			NULL,
+			gettext_noop("Specify 0 to have this value determined as a fraction of \"shared_buffers\"."),
 			GUC_UNIT_BLOCKS
 		},
 		&multixact_offset_buffers,
-		16, 16, SLRU_MAX_ALLOWED_BUFFERS,
+		0, 0, SLRU_MAX_ALLOWED_BUFFERS,
 		check_multixact_offset_buffers, NULL, NULL
 	},
 
@@ -2969,6 +2980,27 @@ struct config_int ConfigureNamesInt[] =
 		check_wal_buffers, NULL, NULL
 	},
 
+	{
+		{"wal_compression_threshold", PGC_SUSET, WAL_SETTINGS,
+			gettext_noop("Sets the minimum size of WAL records without full-page writes to compress as a whole."),
+			gettext_noop("-1 disables compression of such records."),
+			GUC_UNIT_BYTE
+		},
+		&wal_compression_threshold,
+		-1, -1, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"wal_insert_locks", PGC_POSTMASTER, WAL_SETTINGS,
+			gettext_noop("Sets the number of locks used for concurrent WAL insertions."),
+			gettext_noop("Specify -1 to have this value determined from \"max_connections\".")
+		},
+		&XLogInsertLocks,
+		-1, -1, MAX_XLOGINSERT_LOCKS,
+		check_wal_insert_locks, NULL, NULL
+	},
+
 	{
 		{"wal_writer_delay", PGC_SIGHUP, WAL_SETTINGS,
 			gettext_noop("Time between WAL flushes performed in the WAL writer."),
@@ -3609,6 +3641,17 @@ struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"jit_warmup_evaluations", PGC_USERSET, QUERY_TUNING_COST,
+			gettext_noop("Sets the number of times an expression is interpreted before it is JIT compiled."),
+			gettext_noop("0 compiles expressions the first time they are evaluated."),
+			GUC_EXPLAIN
+		},
+		&jit_warmup_evaluations,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
 	{
 		/* Can't be set in postgresql.conf */
 		{"server_version_num", PGC_INTERNAL, PRESET_OPTIONS,
@@ -182,6 +182,14 @@ typedef struct HashScanOpaqueData
 	int		   *killedItems;	/* currPos.items indexes of killed items */
 	int			numKilled;		/* number of currently stored items */
 
+	/*
+	 * Last currPos.items index whose heap TID was reported by
+	 * hashgetprefetchtids (scanning in prefetchDir), or -1 if none has been
+	 * reported since currPos was last filled.
+	 */
+	int			prefetchItem;
+	ScanDirection prefetchDir;
+
 	/*
 	 * Identify all the matching items on a page and save them in
 	 * HashScanPosData
@@ -369,6 +377,8 @@ extern bool hashinsert(Relation rel, Datum *values, bool *isnull,
 					   bool indexUnchanged,
 					   struct IndexInfo *indexInfo);
 extern bool hashgettuple(IndexScanDesc scan, ScanDirection dir);
+extern int	hashgetprefetchtids(IndexScanDesc scan, ScanDirection dir,
+								ItemPointerData *tids, int ntids);
 extern int64 hashgetbitmap(IndexScanDesc scan, TIDBitmap *tbm);
 extern IndexScanDesc hashbeginscan(Relation rel, int nkeys, int norderbys);
 extern void hashrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,
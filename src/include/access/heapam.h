@@ -118,6 +118,11 @@ typedef struct IndexFetchHeapData
 
 	Buffer		xs_cbuf;		/* current heap buffer in scan, if any */
 	/* NB: if xs_cbuf is not InvalidBuffer, we hold a pin on that buffer */
+
+	/* state for heapam_index_fetch_prefetch */
+	BlockNumber xs_prefetch_block;	/* last block considered */
+	int			xs_prefetch_hits;	/* consecutive blocks needing no I/O */
+	int			xs_prefetch_skip;	/* TIDs left to ignore after giving up */
 } IndexFetchHeapData;
 
 /* Result codes for HeapTupleSatisfiesVacuum */
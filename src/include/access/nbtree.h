@@ -1065,6 +1065,14 @@ typedef struct BTScanOpaqueData
 	 */
 	int			markItemIndex;	/* itemIndex, or -1 if not valid */
 
+	/*
+	 * prefetchItem is the last currPos.items[] index whose heap TID was
+	 * reported by btgetprefetchtids (scanning in prefetchDir), or -1 if none
+	 * has been reported since currPos was last filled.
+	 */
+	int			prefetchItem;
+	ScanDirection prefetchDir;
+
 	/* keep these last in struct for efficiency */
 	BTScanPosData currPos;		/* current position data */
 	BTScanPosData markPos;		/* marked position, if any */
@@ -1162,6 +1170,8 @@ extern IndexScanDesc btbeginscan(Relation rel, int nkeys, int norderbys);
 extern Size btestimateparallelscan(int nkeys, int norderbys);
 extern void btinitparallelscan(void *target);
 extern bool btgettuple(IndexScanDesc scan, ScanDirection dir);
+extern int	btgetprefetchtids(IndexScanDesc scan, ScanDirection dir,
+							  ItemPointerData *tids, int ntids);
 extern int64 btgetbitmap(IndexScanDesc scan, TIDBitmap *tbm);
 extern void btrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,
 					 ScanKey orderbys, int norderbys);
@@ -307,6 +307,13 @@ struct XLogReaderState
 	char	   *readRecordBuf;
 	uint32		readRecordBufSize;
 
+	/*
+	 * Buffer for the decompressed contents of a record that was compressed
+	 * as a whole (expandable), used while decoding it.
+	 */
+	char	   *decompressBuf;
+	uint32		decompressBufSize;
+
 	/* Buffer to hold error message */
 	char	   *errormsg_buf;
 	bool		errormsg_deferred;
@@ -394,6 +401,7 @@ extern bool WALRead(XLogReaderState *state,
 
 /* Functions for decoding an XLogRecord */
 
+extern uint32 XLogRecordUncompressedLen(XLogRecord *record);
 extern size_t DecodeXLogRecordRequiredSpace(size_t xl_tot_len);
 extern bool DecodeXLogRecord(XLogReaderState *state,
 							 DecodedXLogRecord *decoded,
@@ -226,6 +226,25 @@ typedef struct XLogRecordDataHeaderLong
 
 #define SizeOfXLogRecordDataHeaderLong (sizeof(uint8) + sizeof(uint32))
 
+/*
+ * A record that carries no full-page images can have everything following
+ * the fixed-size XLogRecord header compressed as a whole, when
+ * wal_compression is enabled and the record is at least
+ * wal_compression_threshold bytes long.  In that case, the record header is
+ * immediately followed by an XLogRecordCompressedHeader, and then by the
+ * compressed form of the block headers, block data and main data that would
+ * otherwise have followed the record header.  'method' is one of the
+ * BKPIMAGE_COMPRESS_* flags.
+ */
+typedef struct XLogRecordCompressedHeader
+{
+	uint8		id;				/* XLR_BLOCK_ID_COMPRESSED */
+	uint8		method;			/* compression method used */
+	/* followed by uint32 raw_length, unaligned */
+}			XLogRecordCompressedHeader;
+
+#define SizeOfXLogRecordCompressedHeader (sizeof(uint8) * 2 + sizeof(uint32))
+
 /*
  * Block IDs used to distinguish different kinds of record fragments. Block
  * references are numbered from 0 to XLR_MAX_BLOCK_ID. A rmgr is free to use
@@ -244,5 +263,6 @@ typedef struct XLogRecordDataHeaderLong
 #define XLR_BLOCK_ID_DATA_LONG		254
 #define XLR_BLOCK_ID_ORIGIN			253
 #define XLR_BLOCK_ID_TOPLEVEL_XID	252
+#define XLR_BLOCK_ID_COMPRESSED		251
 
 #endif							/* XLOGRECORD_H */
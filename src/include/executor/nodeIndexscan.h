@@ -43,5 +43,8 @@ extern void ExecIndexEvalRuntimeKeys(ExprContext *econtext,
 extern bool ExecIndexEvalArrayKeys(ExprContext *econtext,
 								   IndexArrayKeyInfo *arrayKeys, int numArrayKeys);
 extern bool ExecIndexAdvanceArrayKeys(IndexArrayKeyInfo *arrayKeys, int numArrayKeys);
+extern int	ExecIndexPrefetchDistance(Relation heapRelation, Relation indexRelation);
+extern void ExecIndexPrefetch(IndexScanDesc scandesc, ScanDirection direction,
+							  ItemPointerData *tids, int maxtids, Buffer *vmbuffer);
 
 #endif							/* NODEINDEXSCAN_H */
@@ -31,8 +31,8 @@
  * Buffer state is a single 32-bit variable where following data is combined.
  *
  * - 18 bits refcount
- * - 4 bits usage count
- * - 10 bits of flags
+ * - 3 bits usage count
+ * - 11 bits of flags
  *
  * Combining these values allows to perform some operations without locking
  * the buffer header, by modifying them together with a CAS loop.
@@ -41,10 +41,10 @@
  */
 #define BUF_REFCOUNT_ONE 1
 #define BUF_REFCOUNT_MASK ((1U << 18) - 1)
-#define BUF_USAGECOUNT_MASK 0x003C0000U
+#define BUF_USAGECOUNT_MASK 0x001C0000U
 #define BUF_USAGECOUNT_ONE (1U << 18)
 #define BUF_USAGECOUNT_SHIFT 18
-#define BUF_FLAG_MASK 0xFFC00000U
+#define BUF_FLAG_MASK 0xFFE00000U
 
 /* Get refcount and usagecount from buffer state */
 #define BUF_STATE_GET_REFCOUNT(state) ((state) & BUF_REFCOUNT_MASK)
@@ -56,6 +56,8 @@
  * Note: BM_TAG_VALID essentially means that there is a buffer hashtable
  * entry associated with the buffer's tag.
  */
+#define BM_REFERENCED			(1U << 21)	/* usage count bumped since last
+											 * visited by clock sweep */
 #define BM_LOCKED				(1U << 22)	/* buffer header is locked */
 #define BM_DIRTY				(1U << 23)	/* data needs writing */
 #define BM_VALID				(1U << 24)	/* data is valid */
@@ -74,9 +76,20 @@
  * But it can take as many as BM_MAX_USAGE_COUNT+1 complete cycles of
  * clock sweeps to find a free buffer, so in practice we don't want the
  * value to be very large.
+ *
+ * To make the usage count resistant to bursts of correlated references, such
+ * as a large scan or nested loop touching the same pages over and over, it is
+ * incremented at most once between visits of the clock hand.  BM_REFERENCED
+ * records that the increment has happened; the clock sweep clears it instead
+ * of decrementing the usage count.  The usage count thus approximates the
+ * number of clock sweep cycles in which the buffer was used, rather than the
+ * number of times it was pinned.
  */
 #define BM_MAX_USAGE_COUNT	5
 
+StaticAssertDecl(BM_MAX_USAGE_COUNT <= (BUF_USAGECOUNT_MASK >> BUF_USAGECOUNT_SHIFT),
+				 "BM_MAX_USAGE_COUNT doesn't fit in BUF_USAGECOUNT_MASK");
+
 /*
  * Buffer tag identifies which disk block the buffer contains.
  *
@@ -52,6 +52,7 @@ extern void DropRelationFiles(RelFileLocator *delrels, int ndelrels, bool isRedo
 
 /* md sync callbacks */
 extern int	mdsyncfiletag(const FileTag *ftag, char *path);
+extern void mdflushfiletag(const FileTag *ftag);
 extern int	mdunlinkfiletag(const FileTag *ftag, char *path);
 extern bool mdfiletagmatches(const FileTag *ftag, const FileTag *candidate);
 
@@ -110,6 +110,9 @@ extern void smgrtruncate(SMgrRelation reln, ForkNumber *forknum,
 extern void smgrimmedsync(SMgrRelation reln, ForkNumber forknum);
 extern void smgrregistersync(SMgrRelation reln, ForkNumber forknum);
 extern void AtEOXact_SMgr(void);
+extern Size SMgrShmemSize(void);
+extern void SMgrShmemInit(void);
+extern void smgrforgetdatabasesizes(Oid dbid);
 extern bool ProcessBarrierSmgrRelease(void);
 
 static inline void
@@ -314,6 +314,7 @@ dihandler(PG_FUNCTION_ARGS)
 	amroutine->ambeginscan = dibeginscan;
 	amroutine->amrescan = direscan;
 	amroutine->amgettuple = NULL;
+	amroutine->amgetprefetchtids = NULL;
 	amroutine->amgetbitmap = NULL;
 	amroutine->amendscan = diendscan;
 	amroutine->ammarkpos = NULL;
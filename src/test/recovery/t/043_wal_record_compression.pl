@@ -0,0 +1,99 @@
+
+# Copyright (c) 2024, PostgreSQL Global Development Group
+
+# Test that WAL records compressed as a whole, per wal_compression_threshold,
+# are replayed correctly on a standby and can be decoded by pg_waldump.
+
+use strict;
+use warnings FATAL => 'all';
+
+use PostgreSQL::Test::Cluster;
+use PostgreSQL::Test::Utils;
+use Test::More;
+
+my @methods = ('pglz');
+push @methods, 'lz4' if check_pg_config("#define USE_LZ4 1");
+push @methods, 'zstd' if check_pg_config("#define USE_ZSTD 1");
+
+my $node_primary = PostgreSQL::Test::Cluster->new('primary');
+$node_primary->init(allows_streaming => 1);
+$node_primary->start;
+
+my $backup_name = 'my_backup';
+$node_primary->backup($backup_name);
+
+my $node_standby = PostgreSQL::Test::Cluster->new('standby');
+$node_standby->init_from_backup($node_primary, $backup_name,
+	has_streaming => 1);
+$node_standby->start;
+
+# Size of the logical decoding message payload.  It has to stay below twice
+# the block size, above which records are never compressed.
+my $payload_len = 6000;
+my (%message_start, %message_end);
+
+foreach my $method (@methods)
+{
+	# wal_compression and wal_compression_threshold only last for the
+	# session, so everything has to be done in a single psql call.
+	# pg_logical_emit_message() returns the end of the message record, so
+	# fetch the insert position first to know where the record starts.
+	my $lsns = $node_primary->safe_psql(
+		'postgres', qq{
+SET wal_compression = '$method';
+SET wal_compression_threshold = 64;
+CREATE TABLE tab_$method (id int, data text);
+INSERT INTO tab_$method
+  SELECT g, repeat('compressible ' || (g % 10), 20)
+    FROM generate_series(1, 2000) g;
+UPDATE tab_$method SET data = repeat('updated ' || (id % 7), 25)
+  WHERE id % 3 = 0;
+DELETE FROM tab_$method WHERE id % 5 = 0;
+SELECT pg_current_wal_insert_lsn();
+SELECT pg_logical_emit_message(false, 'wal_compress',
+  repeat('abc', $payload_len / 3));
+});
+	($message_start{$method}, $message_end{$method}) = split /\n/, $lsns;
+}
+
+$node_primary->wait_for_replay_catchup($node_standby);
+
+foreach my $method (@methods)
+{
+	my $query = qq{SELECT count(*), sum(id), md5(string_agg(data, ',' ORDER BY id))
+  FROM tab_$method};
+	my $primary_result = $node_primary->safe_psql('postgres', $query);
+	my $standby_result = $node_standby->safe_psql('postgres', $query);
+
+	is($standby_result, $primary_result,
+		"records compressed with $method replayed on standby");
+
+	# Check that pg_waldump decodes the logical decoding message, and that
+	# it has actually been stored compressed.  Other processes may have
+	# inserted records around it, so look for it among the records in the
+	# range.
+	my (@cmd, $stdout, $stderr, $result);
+
+	@cmd = (
+		'pg_waldump', '-p', $node_primary->data_dir,
+		'--start', $message_start{$method},
+		'--end', $message_end{$method});
+	$result = IPC::Run::run \@cmd, '>', \$stdout, '2>', \$stderr;
+	ok($result, "pg_waldump decodes records compressed with $method");
+
+	my @messages = grep { /prefix "wal_compress"/ } split /\n/, $stdout;
+	is(scalar @messages, 1,
+		"pg_waldump shows message compressed with $method");
+	like(
+		$messages[0] // '',
+		qr/^rmgr: LogicalMessage .*payload \($payload_len bytes\)/,
+		"pg_waldump shows full payload of message compressed with $method");
+
+	my ($tot_len) =
+	  ($messages[0] // '') =~ qr{len \(rec/tot\):\s*\d+/\s*(\d+)};
+	ok(defined $tot_len && $tot_len < $payload_len,
+		"message record compressed with $method is smaller than its payload"
+	);
+}
+
+done_testing();
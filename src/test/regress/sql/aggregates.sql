@@ -1594,6 +1594,18 @@ select (g/2)::numeric as c1, array_agg(g::numeric) as c2, count(*) as c3
 set enable_sort = true;
 set work_mem to default;
 
+-- Produce results with JIT compilation deferred until expressions are hot
+
+set jit_above_cost = 0;
+set jit_warmup_evaluations = 1000;
+
+create table agg_warmup_1 as
+select g%10000 as c1, sum(g::numeric) as c2, count(*) as c3
+  from agg_data_20k group by g%10000;
+
+set jit_warmup_evaluations to default;
+set jit_above_cost to default;
+
 -- Compare group aggregation results to hash aggregation results
 
 (select * from agg_hash_1 except select * from agg_group_1)
@@ -1612,6 +1624,12 @@ set work_mem to default;
   union all
 (select * from agg_group_4 except select * from agg_hash_4);
 
+-- Compare results produced with JIT warm-up to hash aggregation results
+
+(select * from agg_warmup_1 except select * from agg_hash_1)
+  union all
+(select * from agg_hash_1 except select * from agg_warmup_1);
+
 drop table agg_group_1;
 drop table agg_group_2;
 drop table agg_group_3;
@@ -1620,3 +1638,4 @@ drop table agg_hash_1;
 drop table agg_hash_2;
 drop table agg_hash_3;
 drop table agg_hash_4;
+drop table agg_warmup_1;